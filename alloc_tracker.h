@@ -0,0 +1,205 @@
+#pragma once
+
+// Rastreamento de alocações (opção RASTREAR_ALOCACOES do CMake).
+// Substitui os operator new/delete globais para contar cada alocação por thread e por subsistema; as
+// alocações em C do stb_image passam pelo stb_leakcheck (ver main.cpp), que também lista ao sair o que
+// não foi liberado. ALLOCATION_SCOPE("nome") atribui ao subsistema "nome" as alocações feitas pela
+// thread atual até o fim do escopo; as demais contam como "outros".
+// Sem RASTREAR_ALOCACOES a macro não gera código.
+// Defina ALLOC_TRACKER_IMPLEMENTATION em exatamente um arquivo antes de incluir este cabeçalho.
+
+#ifdef RASTREAR_ALOCACOES
+
+#include <atomic>  // Contadores compartilhados entre threads.
+#include <cstdint>  // uint64_t.
+#include <cstdlib>  // malloc, free.
+#include <cstring>  // strcmp.
+#include <iomanip>  // Formatação do relatório.
+#include <iostream>  // Relatório no console.
+#include <mutex>  // Registro de subsistemas.
+#include <new>  // bad_alloc, nothrow_t.
+
+class AllocationTracker {
+public:
+    static const int maxSubsystems = 32;
+
+    // Chamado por operator new e pelas alocações em C rastreadas.
+    static void onAllocate() {
+        ++threadCount();
+        counts()[threadSubsystem()].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Alocações feitas pela thread atual desde o início.
+    static uint64_t threadAllocations() {
+        return threadCount();
+    }
+
+    // Índice do subsistema com este nome, registrando-o na primeira vez.
+    static int subsystemIndex(const char* name) {
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < subsystemCount(); ++i) {
+            if (strcmp(names()[i], name) == 0)
+                return i;
+        }
+        if (subsystemCount() == maxSubsystems)
+            return 0;
+        names()[subsystemCount()] = name;
+        return subsystemCount()++;
+    }
+
+    // Troca o subsistema da thread atual; retorna o anterior.
+    static int enterSubsystem(int index) {
+        int previous = threadSubsystem();
+        threadSubsystem() = index;
+        return previous;
+    }
+
+    // Total de alocações por subsistema desde o início.
+    static void report(std::ostream& out) {
+        out << "Alocações por subsistema:" << std::endl;
+        for (int i = 0; i < subsystemCount(); ++i) {
+            uint64_t count = counts()[i].load(std::memory_order_relaxed);
+            if (count > 0)
+                out << "  " << std::left << std::setw(24) << names()[i] << std::right << std::setw(10) << count << std::endl;
+        }
+    }
+
+private:
+    // Estado em variáveis estáticas locais de tipos triviais: são zeradas antes de qualquer construtor
+    // global rodar, então funcionam mesmo nas alocações feitas durante a inicialização do programa.
+    static uint64_t& threadCount() {
+        thread_local uint64_t count = 0;
+        return count;
+    }
+
+    static int& threadSubsystem() {
+        thread_local int index = 0;
+        return index;
+    }
+
+    static std::atomic<uint64_t>* counts() {
+        static std::atomic<uint64_t> values[maxSubsystems];
+        return values;
+    }
+
+    static const char** names() {
+        static const char* values[maxSubsystems] = { "outros" };
+        return values;
+    }
+
+    static int& subsystemCount() {
+        static int count = 1;
+        return count;
+    }
+};
+
+// Atribui as alocações da thread atual a um subsistema enquanto o objeto existir.
+class AllocationScope {
+public:
+    explicit AllocationScope(int index) : previous(AllocationTracker::enterSubsystem(index)) {}
+
+    ~AllocationScope() {
+        AllocationTracker::enterSubsystem(previous);
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    int previous;
+};
+
+// Alocações por quadro em uma thread: os quadros de aquecimento (cache, primeiras zonas do perfilador,
+// etc.) são ignorados; depois deles o esperado é zero.
+class FrameAllocationCounter {
+public:
+    explicit FrameAllocationCounter(int warmupFrames) : warmupFrames(warmupFrames) {}
+
+    void beginFrame() {
+        atFrameStart = AllocationTracker::threadAllocations();
+    }
+
+    void endFrame() {
+        uint64_t count = AllocationTracker::threadAllocations() - atFrameStart;
+        if (++frames <= warmupFrames)
+            return;
+        if (count > 0) {
+            ++framesWithAllocations;
+            totalAllocations += count;
+            maxPerFrame = count > maxPerFrame ? count : maxPerFrame;
+        }
+    }
+
+    int64_t framesAllocating() const {
+        return framesWithAllocations;
+    }
+
+    void report(std::ostream& out) const {
+        out << "Alocações na thread principal depois de " << warmupFrames << " quadros de aquecimento: " << totalAllocations
+            << " em " << framesWithAllocations << " de " << (frames > warmupFrames ? frames - warmupFrames : 0)
+            << " quadros (máximo " << maxPerFrame << " em um quadro)." << std::endl;
+    }
+
+private:
+    const int64_t warmupFrames;
+    uint64_t atFrameStart = 0;
+    int64_t frames = 0;
+    int64_t framesWithAllocations = 0;
+    uint64_t totalAllocations = 0;
+    uint64_t maxPerFrame = 0;
+};
+
+#define ALLOCATION_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_INNER(a, b)
+#define ALLOCATION_SCOPE(name)                                                                   \
+    static const int ALLOCATION_CONCAT(allocationIndex, __LINE__) = AllocationTracker::subsystemIndex(name); \
+    AllocationScope ALLOCATION_CONCAT(allocationScope, __LINE__)(ALLOCATION_CONCAT(allocationIndex, __LINE__))
+
+#ifdef ALLOC_TRACKER_IMPLEMENTATION
+#undef ALLOC_TRACKER_IMPLEMENTATION
+
+void* operator new(size_t size) {
+    AllocationTracker::onAllocate();
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    AllocationTracker::onAllocate();
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+#endif
+
+#else
+
+#define ALLOCATION_SCOPE(name) ((void)0)
+
+#endif
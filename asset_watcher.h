@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>  // uint64_t do eventfd.
+#include <string>  // Caminhos dos arquivos observados.
+#include <vector>  // Lista de arquivos alterados.
+#include <mutex>  // Proteção da lista de arquivos alterados.
+#include <thread>  // Thread que espera pelos eventos do sistema.
+#include <iostream>  // Mensagens de erro.
+#ifdef __linux__
+#include <sys/inotify.h>  // Notificações de alteração de arquivos.
+#include <sys/eventfd.h>  // Sinal para encerrar a thread de observação.
+#include <poll.h>  // Espera simultânea pelos dois descritores.
+#include <unistd.h>  // read, write, close.
+#endif
+
+// Observa arquivos de imagem e informa quais mudaram, para que o jogo recarregue só essas texturas
+// (AsyncTextureLoader::reloadFile). A espera pelos eventos acontece em uma thread própria; a thread de
+// renderização apenas consulta poll() uma vez por quadro, sem bloquear.
+// Usa inotify no Linux; nas demais plataformas o observador existe mas nunca informa alterações.
+class AssetWatcher {
+public:
+    AssetWatcher() {
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotifyFd < 0 || stopFd < 0) {
+            std::cerr << "Falha ao iniciar o inotify; recarregamento de assets desativado." << std::endl;
+            return;
+        }
+        thread = std::thread(&AssetWatcher::watchLoop, this);
+#endif
+    }
+
+    ~AssetWatcher() {
+#ifdef __linux__
+        if (thread.joinable()) {
+            uint64_t one = 1;
+            ssize_t written = write(stopFd, &one, sizeof(one));
+            (void)written;
+            thread.join();
+        }
+        if (inotifyFd >= 0)
+            close(inotifyFd);
+        if (stopFd >= 0)
+            close(stopFd);
+#endif
+    }
+
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    // Passa a observar um arquivo. O diretório inteiro é observado, pois editores costumam salvar
+    // gravando um arquivo temporário e renomeando-o por cima do original.
+    void watch(const std::string& filePath) {
+#ifdef __linux__
+        if (inotifyFd < 0)
+            return;
+        size_t slash = filePath.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : filePath.substr(0, slash);
+        std::string name = slash == std::string::npos ? filePath : filePath.substr(slash + 1);
+
+        int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            std::cerr << "Falha ao observar: " << directory << std::endl;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        watched.push_back(Watched{ wd, name, filePath });
+#else
+        (void)filePath;
+#endif
+    }
+
+    // Chama onChanged(caminho) para cada arquivo observado que mudou desde a última chamada.
+    // Deve ser chamado pela thread de renderização; não bloqueia e não aloca memória quando não há alterações.
+    template <typename Callback>
+    void poll(Callback&& onChanged) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (changed.empty())
+                return;
+            delivering.swap(changed);
+        }
+        for (const auto& path : delivering)
+            onChanged(path);
+        delivering.clear();
+    }
+
+private:
+    struct Watched {
+        int wd;  // Descritor do diretório no inotify.
+        std::string name;  // Nome do arquivo dentro do diretório.
+        std::string path;  // Caminho como foi passado para watch().
+    };
+
+#ifdef __linux__
+    // Laço da thread de observação: espera eventos do inotify e agrupa as alterações que chegam em
+    // sequência (um editor pode gravar o mesmo arquivo várias vezes ao salvar) antes de publicá-las.
+    void watchLoop() {
+        alignas(inotify_event) char buffer[4096];
+        std::vector<std::string> pending;
+        pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+
+        while (true) {
+            int timeout = pending.empty() ? -1 : debounceMs;
+            int ready = ::poll(fds, 2, timeout);
+            if (ready < 0)
+                continue;  // Interrompido por um sinal.
+            if (fds[1].revents & POLLIN)
+                return;
+
+            if (ready == 0) {
+                // Nenhum evento novo durante o intervalo: publica as alterações acumuladas.
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& path : pending) {
+                    bool duplicate = false;
+                    for (const auto& existing : changed)
+                        duplicate = duplicate || existing == path;
+                    if (!duplicate)
+                        changed.push_back(path);
+                }
+                pending.clear();
+                continue;
+            }
+
+            ssize_t length;
+            while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+                    if (event->len == 0)
+                        continue;
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (const auto& entry : watched) {
+                        if (entry.wd == event->wd && entry.name == event->name)
+                            pending.push_back(entry.path);
+                    }
+                }
+            }
+        }
+    }
+
+    int inotifyFd = -1;
+    int stopFd = -1;
+    std::thread thread;
+#endif
+
+    static const int debounceMs = 50;  // Tempo sem eventos antes de considerar o arquivo salvo.
+
+    std::mutex mutex;
+    std::vector<Watched> watched;  // Arquivos observados.
+    std::vector<std::string> changed;  // Alterações ainda não entregues por poll().
+    std::vector<std::string> delivering;  // Reutilizado por poll() para não alocar a cada quadro.
+};
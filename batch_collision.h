@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>  // uint64_t.
+#include "game.h"  // Pipe, CollisionMask.
+
+// Colisão em lote de uma população de pássaros (treino do algoritmo genético: milhares de pássaros no mesmo
+// World, com os mesmos tubos) contra o tubo ativo. Todos os pássaros estão no mesmo x, então o teste em x é
+// feito uma vez, e o que sobra por pássaro é o predicado de Pipe::isColliding,
+//   y - 15 < altura || y + 15 > altura + 200,
+// aplicado a 16, 8 ou 4 alturas por vez (AVX-512, AVX2 ou SSE2) de um vetor só com os y (estrutura de
+// vetores). O resultado é um bitset: o bit i de dead fica em 1 quando o pássaro i colide. As operações de
+// ponto flutuante são as mesmas do teste escalar, então o resultado é idêntico bit a bit.
+// O conjunto de instruções é escolhido na compilação (-march=native, /arch:AVX2 ou a opção SIMD_NATIVO do
+// CMake); sem nenhum, a versão escalar é usada.
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define BATCH_COLLISION_AVX512
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define BATCH_COLLISION_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BATCH_COLLISION_SSE2
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>  // _BitScanForward64.
+#endif
+
+// Nome do caminho usado por collideBatch, para os relatórios.
+inline const char* batchCollisionIsa() {
+#if defined(BATCH_COLLISION_AVX512)
+    return "AVX-512";
+#elif defined(BATCH_COLLISION_AVX2)
+    return "AVX2";
+#elif defined(BATCH_COLLISION_SSE2)
+    return "SSE2";
+#else
+    return "escalar";
+#endif
+}
+
+// Índice do bit 1 mais baixo (bits != 0).
+inline int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// Pássaros base .. base + n - 1 (n <= 64) que tocam as caixas do tubo, um bit por pássaro.
+inline uint64_t batchHitsScalar(const float* y, int base, int n, float height) {
+    uint64_t hits = 0;
+    for (int i = 0; i < n; ++i) {
+        if (y[base + i] - 15.0f < height || y[base + i] + 15.0f > height + 200.0f)
+            hits |= uint64_t(1) << i;
+    }
+    return hits;
+}
+
+// O mesmo para um bloco cheio de 64 pássaros, com o conjunto de instruções da compilação.
+inline uint64_t batchHits64(const float* y, int base, float height) {
+#if defined(BATCH_COLLISION_AVX512)
+    const __m512 half = _mm512_set1_ps(15.0f), bottom = _mm512_set1_ps(height), top = _mm512_set1_ps(height + 200.0f);
+    uint64_t hits = 0;
+    for (int i = 0; i < 64; i += 16) {
+        const __m512 v = _mm512_loadu_ps(y + base + i);
+        const __mmask16 below = _mm512_cmp_ps_mask(_mm512_sub_ps(v, half), bottom, _CMP_LT_OQ);
+        const __mmask16 above = _mm512_cmp_ps_mask(_mm512_add_ps(v, half), top, _CMP_GT_OQ);
+        hits |= uint64_t(static_cast<uint16_t>(below | above)) << i;
+    }
+    return hits;
+#elif defined(BATCH_COLLISION_AVX2)
+    const __m256 half = _mm256_set1_ps(15.0f), bottom = _mm256_set1_ps(height), top = _mm256_set1_ps(height + 200.0f);
+    uint64_t hits = 0;
+    for (int i = 0; i < 64; i += 8) {
+        const __m256 v = _mm256_loadu_ps(y + base + i);
+        const __m256 below = _mm256_cmp_ps(_mm256_sub_ps(v, half), bottom, _CMP_LT_OQ);
+        const __m256 above = _mm256_cmp_ps(_mm256_add_ps(v, half), top, _CMP_GT_OQ);
+        hits |= uint64_t(static_cast<unsigned>(_mm256_movemask_ps(_mm256_or_ps(below, above)))) << i;
+    }
+    return hits;
+#elif defined(BATCH_COLLISION_SSE2)
+    const __m128 half = _mm_set1_ps(15.0f), bottom = _mm_set1_ps(height), top = _mm_set1_ps(height + 200.0f);
+    uint64_t hits = 0;
+    for (int i = 0; i < 64; i += 4) {
+        const __m128 v = _mm_loadu_ps(y + base + i);
+        const __m128 below = _mm_cmplt_ps(_mm_sub_ps(v, half), bottom);
+        const __m128 above = _mm_cmpgt_ps(_mm_add_ps(v, half), top);
+        hits |= uint64_t(static_cast<unsigned>(_mm_movemask_ps(_mm_or_ps(below, above)))) << i;
+    }
+    return hits;
+#else
+    return batchHitsScalar(y, base, 64, height);
+#endif
+}
+
+// Marca em dead (count bits, (count + 63) / 64 palavras) os pássaros em (birdX, y[i]) que colidem com o
+// tubo; os bits já marcados continuam marcados. Com máscara de pixels (a mesma para todos), os pássaros
+// que tocam as caixas são conferidos um a um com CollisionMask::overlapsPipe, como em Pipe::isColliding.
+// Com simd = false, usa só a versão escalar (para comparar as duas).
+inline void collideBatch(const float* y, int count, float birdX, const Pipe& pipe, uint64_t* dead,
+                         const CollisionMask* mask = nullptr, bool simd = true) {
+    if (!(birdX + 15.0f > pipe.x - 25.0f && birdX - 15.0f < pipe.x + 25.0f))
+        return;  // Nenhum pássaro está na faixa de x do tubo.
+    for (int base = 0; base < count; base += 64) {
+        const int n = count - base < 64 ? count - base : 64;
+        uint64_t hits = n == 64 && simd ? batchHits64(y, base, pipe.height) : batchHitsScalar(y, base, n, pipe.height);
+        if (mask) {
+            for (uint64_t pending = hits & ~dead[base / 64]; pending; pending &= pending - 1) {
+                const int i = lowestBit(pending);
+                if (!mask->overlapsPipe(birdX, y[base + i], pipe.x, pipe.height))
+                    hits &= ~(uint64_t(1) << i);
+            }
+        }
+        dead[base / 64] |= hits;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>  // sort.
+#include <vector>  // Ordem dos pássaros.
+#include "game.h"  // Bird, Pipe, PipeRing.
+
+// Colisão de muitos pássaros (população de treino, um por indivíduo) contra muitos tubos, por varredura e
+// poda: os pássaros ficam em uma lista de índices ordenada por x e os tubos já estão em ordem na PipeRing.
+// As duas listas são percorridas juntas, e cada pássaro só é testado (com Pipe::isColliding) contra os tubos
+// cuja faixa de x encosta na sua: O(pássaros + tubos + pares próximos) em vez de O(pássaros * tubos).
+class BirdSweep {
+public:
+    // Atualiza a ordem por x. Por inserção: de um quadro para o outro os pássaros quase não trocam de
+    // lugar, e o custo fica quase linear. Quando o número de pássaros muda, a lista é refeita com std::sort.
+    void sort(const Bird* birds, int count) {
+        if (static_cast<int>(order.size()) != count) {
+            order.resize(count);
+            for (int i = 0; i < count; ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), [birds](int a, int b) { return birds[a].x < birds[b].x; });
+            return;
+        }
+        for (int i = 1; i < count; ++i) {
+            const int bird = order[i];
+            int j = i;
+            for (; j > 0 && birds[order[j - 1]].x > birds[bird].x; --j)
+                order[j] = order[j - 1];
+            order[j] = bird;
+        }
+    }
+
+    // Marca dead[i] = 1 para cada pássaro i (vivo) que colide com algum tubo. sort() deve ter sido chamada
+    // depois do último movimento em x. Retorna o número de testes exatos feitos.
+    int collide(const Bird* birds, const PipeRing& ring, unsigned char* dead) const {
+        int tests = 0;
+        int first = 0;  // Primeiro tubo que ainda pode tocar o pássaro atual ou os seguintes.
+        for (int bird : order) {
+            const Bird& b = birds[bird];
+            while (first < ring.size() && ring.at(first).x <= b.x - pipe_reach)
+                ++first;
+            if (dead[bird])
+                continue;
+            for (int i = first; i < ring.size() && ring.at(i).x < b.x + pipe_reach; ++i) {
+                ++tests;
+                if (ring.at(i).isColliding(b)) {
+                    dead[bird] = 1;
+                    break;
+                }
+            }
+        }
+        return tests;
+    }
+
+private:
+    std::vector<int> order;  // Índices dos pássaros em ordem crescente de x.
+};
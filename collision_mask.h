@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>  // uint64_t.
+
+// Máscara de colisão do pássaro no tamanho em que ele é desenhado (30x30 pixels), gerada do canal alfa do
+// sprite: os cantos transparentes de pinto.png não colidem com os tubos. Cada linha é um inteiro de 64 bits
+// (bit c = coluna c), e o teste contra o retângulo de um tubo é uma máscara de colunas (montada com
+// deslocamentos) combinada por AND com as linhas que o retângulo cobre. Como cada tubo cobre sempre as
+// linhas de uma ponta do quadrado, o OR acumulado das linhas a partir de baixo e a partir de cima é
+// guardado junto, e o teste fica com um AND por retângulo, sem laço.
+// A linha 0 é a de baixo do quadrado do pássaro (y - 15), a mesma que recebe a linha 0 da imagem na textura.
+struct CollisionMask {
+    static const int size = 30;  // Lado do quadrado desenhado em Bird::draw().
+    uint64_t rows[size];
+    uint64_t rowsUpTo[size];  // OR das linhas 0..r.
+    uint64_t rowsFrom[size];  // OR das linhas r..size-1.
+
+    // Quadrado cheio: dá exatamente o mesmo resultado que o teste de caixa.
+    static CollisionMask box() {
+        CollisionMask mask;
+        for (int r = 0; r < size; ++r)
+            mask.rows[r] = (uint64_t(1) << size) - 1;
+        mask.accumulate();
+        return mask;
+    }
+
+    // Amostra a imagem RGBA8 (como enviada ao OpenGL) no centro de cada pixel do quadrado desenhado.
+    static CollisionMask fromRgba(const unsigned char* pixels, int width, int height, unsigned char alphaThreshold = 128) {
+        CollisionMask mask;
+        for (int r = 0; r < size; ++r) {
+            const int imageRow = (2 * r + 1) * height / (2 * size);
+            mask.rows[r] = 0;
+            for (int c = 0; c < size; ++c) {
+                const int imageColumn = (2 * c + 1) * width / (2 * size);
+                if (pixels[(static_cast<size_t>(imageRow) * width + imageColumn) * 4 + 3] >= alphaThreshold)
+                    mask.rows[r] |= uint64_t(1) << c;
+            }
+        }
+        mask.accumulate();
+        return mask;
+    }
+
+    // Identifica a máscara na gravação de partidas (replay.h). FNV-1a das linhas.
+    uint64_t hash() const {
+        uint64_t h = 1469598103934665603ull;
+        for (int r = 0; r < size; ++r) {
+            for (int b = 0; b < 8; ++b)
+                h = (h ^ ((rows[r] >> (8 * b)) & 0xFF)) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Testa os pixels do pássaro centrado em (birdX, birdY) contra os dois retângulos de um tubo.
+    // Supõe que o teste de caixa de Pipe::isColliding já deu positivo.
+    bool overlapsPipe(float birdX, float birdY, float pipeX, float pipeHeight) const {
+        const float left = birdX - 15.0f, bottom = birdY - 15.0f;
+
+        // Colunas do pássaro que cobrem alguma parte de (pipeX - 25, pipeX + 25).
+        int c0 = floorToInt(pipeX - 25.0f - left);
+        int c1 = ceilToInt(pipeX + 25.0f - left) - 1;
+        c0 = c0 < 0 ? 0 : (c0 > size - 1 ? size - 1 : c0);
+        c1 = c1 > size - 1 ? size - 1 : (c1 < 0 ? 0 : c1);
+        const uint64_t columns = ((uint64_t(2) << c1) - 1) & ~((uint64_t(1) << c0) - 1);
+
+        // Tubo de baixo: linhas abaixo de pipeHeight. Tubo de cima: linhas acima de pipeHeight + 200.
+        // As duas escolhas são feitas sem desvios, que seriam imprevisíveis perto das bordas dos tubos.
+        int r1 = ceilToInt(pipeHeight - bottom) - 1;
+        int r0 = floorToInt(pipeHeight + 200.0f - bottom);
+        r1 = r1 > size - 1 ? size - 1 : (r1 < 0 ? 0 : r1);
+        r0 = r0 < 0 ? 0 : (r0 > size - 1 ? size - 1 : r0);
+        const uint64_t lower = birdY - 15.0f < pipeHeight ? rowsUpTo[r1] : 0;
+        const uint64_t upper = birdY + 15.0f > pipeHeight + 200.0f ? rowsFrom[r0] : 0;
+        return ((lower | upper) & columns) != 0;
+    }
+
+private:
+    void accumulate() {
+        uint64_t below = 0, above = 0;
+        for (int r = 0; r < size; ++r) {
+            below |= rows[r];
+            rowsUpTo[r] = below;
+            above |= rows[size - 1 - r];
+            rowsFrom[size - 1 - r] = above;
+        }
+    }
+
+    // std::floor e std::ceil viram chamadas de biblioteca sem SSE4.1; as distâncias aqui cabem em um int.
+    static int floorToInt(float value) {
+        int i = static_cast<int>(value);
+        return i - (value < static_cast<float>(i) ? 1 : 0);
+    }
+
+    static int ceilToInt(float value) {
+        int i = static_cast<int>(value);
+        return i + (value > static_cast<float>(i) ? 1 : 0);
+    }
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstdint>  // Tipos inteiros de tamanho fixo.
+#include <cstring>  // memcpy.
+#include <fstream>  // Leitura do arquivo .dds.
+#include <vector>  // Armazenamento dos blocos comprimidos.
+
+// Formato DDS (DirectDraw Surface) com blocos BC1 (DXT1) e BC3 (DXT5).
+// O arquivo é gerado offline pela ferramenta CompressorTexturas (tools/compress_textures.cpp)
+// e carregado pelo jogo com glCompressedTexImage2D quando o driver suporta S3TC.
+
+const uint32_t DDS_MAGIC = 0x20534444;  // "DDS ".
+const uint32_t DDS_FOURCC_DXT1 = 0x31545844;  // "DXT1".
+const uint32_t DDS_FOURCC_DXT5 = 0x35545844;  // "DXT5".
+
+const uint32_t DDSD_CAPS = 0x1;
+const uint32_t DDSD_HEIGHT = 0x2;
+const uint32_t DDSD_WIDTH = 0x4;
+const uint32_t DDSD_PIXELFORMAT = 0x1000;
+const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+const uint32_t DDSD_LINEARSIZE = 0x80000;
+const uint32_t DDPF_FOURCC = 0x4;
+const uint32_t DDSCAPS_COMPLEX = 0x8;
+const uint32_t DDSCAPS_TEXTURE = 0x1000;
+const uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+struct DdsPixelFormat {
+    uint32_t size, flags, fourCC, rgbBitCount;
+    uint32_t rBitMask, gBitMask, bBitMask, aBitMask;
+};
+
+struct DdsHeader {
+    uint32_t size, flags, height, width, pitchOrLinearSize, depth, mipMapCount;
+    uint32_t reserved1[11];
+    DdsPixelFormat pixelFormat;
+    uint32_t caps, caps2, caps3, caps4, reserved2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "Cabeçalho DDS deve ter 124 bytes.");
+
+// Um nível de mipmap já comprimido.
+struct DdsLevel {
+    int width, height;
+    std::vector<unsigned char> blocks;
+};
+
+// Imagem comprimida com todos os níveis de mipmap.
+struct DdsImage {
+    bool hasAlpha = false;  // true = BC3 (DXT5), false = BC1 (DXT1).
+    std::vector<DdsLevel> levels;
+};
+
+// Tamanho em bytes de um bloco 4x4: 8 para BC1 e 16 para BC3.
+inline int ddsBlockSize(bool hasAlpha) {
+    return hasAlpha ? 16 : 8;
+}
+
+// Tamanho em bytes de um nível com as dimensões fornecidas (arredondado para blocos 4x4).
+inline size_t ddsLevelSize(int width, int height, bool hasAlpha) {
+    size_t blocksX = (width + 3) / 4;
+    size_t blocksY = (height + 3) / 4;
+    return blocksX * blocksY * ddsBlockSize(hasAlpha);
+}
+
+// Lê um arquivo .dds com BC1 ou BC3. Retorna false se o arquivo não existir ou não for suportado.
+inline bool readDds(const char* filePath, DdsImage& image) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    uint32_t magic = 0;
+    DdsHeader header;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || magic != DDS_MAGIC || header.size != sizeof(DdsHeader))
+        return false;
+    if (!(header.pixelFormat.flags & DDPF_FOURCC))
+        return false;
+
+    if (header.pixelFormat.fourCC == DDS_FOURCC_DXT1)
+        image.hasAlpha = false;
+    else if (header.pixelFormat.fourCC == DDS_FOURCC_DXT5)
+        image.hasAlpha = true;
+    else
+        return false;
+
+    int width = static_cast<int>(header.width);
+    int height = static_cast<int>(header.height);
+    uint32_t mipCount = (header.flags & DDSD_MIPMAPCOUNT) && header.mipMapCount > 0 ? header.mipMapCount : 1;
+
+    image.levels.clear();
+    for (uint32_t i = 0; i < mipCount && width > 0 && height > 0; ++i) {
+        DdsLevel level;
+        level.width = width;
+        level.height = height;
+        level.blocks.resize(ddsLevelSize(width, height, image.hasAlpha));
+        file.read(reinterpret_cast<char*>(level.blocks.data()), level.blocks.size());
+        if (!file)
+            return false;
+        image.levels.push_back(std::move(level));
+
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        if (image.levels.back().width == 1 && image.levels.back().height == 1)
+            break;
+    }
+    return !image.levels.empty();
+}
+
+// Grava uma imagem comprimida no formato .dds.
+inline bool writeDds(const char* filePath, const DdsImage& image) {
+    if (image.levels.empty())
+        return false;
+
+    DdsHeader header = {};
+    header.size = sizeof(DdsHeader);
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.width = image.levels[0].width;
+    header.height = image.levels[0].height;
+    header.pitchOrLinearSize = static_cast<uint32_t>(image.levels[0].blocks.size());
+    header.mipMapCount = static_cast<uint32_t>(image.levels.size());
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.pixelFormat.fourCC = image.hasAlpha ? DDS_FOURCC_DXT5 : DDS_FOURCC_DXT1;
+    header.caps = DDSCAPS_TEXTURE;
+    if (image.levels.size() > 1)
+        header.caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file)
+        return false;
+    file.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& level : image.levels)
+        file.write(reinterpret_cast<const char*>(level.blocks.data()), level.blocks.size());
+    return static_cast<bool>(file);
+}
+
+// Expande uma cor RGB565 para RGB888.
+inline void ddsExpand565(uint16_t c, unsigned char* rgb) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+    rgb[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+    rgb[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+}
+
+// Decodifica a parte de cor de um bloco (8 bytes) em 16 pixels RGBA.
+// No BC3 a cor usa sempre o modo de 4 cores; no BC1, c0 <= c1 indica o modo com transparência.
+inline void ddsDecodeColorBlock(const unsigned char* block, unsigned char* out, bool forceFourColors) {
+    uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+    uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+
+    unsigned char palette[4][4];
+    ddsExpand565(c0, palette[0]);
+    ddsExpand565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = 255;
+    for (int k = 0; k < 3; ++k) {
+        if (forceFourColors || c0 > c1) {
+            palette[2][k] = static_cast<unsigned char>((2 * palette[0][k] + palette[1][k]) / 3);
+            palette[3][k] = static_cast<unsigned char>((palette[0][k] + 2 * palette[1][k]) / 3);
+        }
+        else {
+            palette[2][k] = static_cast<unsigned char>((palette[0][k] + palette[1][k]) / 2);
+            palette[3][k] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = (forceFourColors || c0 > c1) ? 255 : 0;
+
+    for (int i = 0; i < 16; ++i)
+        memcpy(out + i * 4, palette[(indices >> (2 * i)) & 3], 4);
+}
+
+// Decodifica a parte de alfa de um bloco BC3 (8 bytes), sobrescrevendo o canal alfa dos 16 pixels.
+inline void ddsDecodeAlphaBlock(const unsigned char* block, unsigned char* out) {
+    int a0 = block[0], a1 = block[1];
+    unsigned char palette[8];
+    palette[0] = static_cast<unsigned char>(a0);
+    palette[1] = static_cast<unsigned char>(a1);
+    if (a0 > a1) {
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = static_cast<unsigned char>(((7 - i) * a0 + i * a1) / 7);
+    }
+    else {
+        for (int i = 1; i < 5; ++i)
+            palette[i + 1] = static_cast<unsigned char>(((5 - i) * a0 + i * a1) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    for (int i = 0; i < 16; ++i)
+        out[i * 4 + 3] = palette[(indices >> (3 * i)) & 7];
+}
+
+// Decodifica um nível comprimido para RGBA8. Usado quando o driver não suporta S3TC.
+inline std::vector<unsigned char> ddsDecodeLevel(const DdsLevel& level, bool hasAlpha) {
+    std::vector<unsigned char> rgba(static_cast<size_t>(level.width) * level.height * 4);
+    const int blockSize = ddsBlockSize(hasAlpha);
+    const int blocksX = (level.width + 3) / 4;
+    const int blocksY = (level.height + 3) / 4;
+    unsigned char pixels[16 * 4];
+
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            const unsigned char* block = level.blocks.data() + (static_cast<size_t>(by) * blocksX + bx) * blockSize;
+            if (hasAlpha) {
+                ddsDecodeColorBlock(block + 8, pixels, true);
+                ddsDecodeAlphaBlock(block, pixels);
+            }
+            else {
+                ddsDecodeColorBlock(block, pixels, false);
+            }
+
+            // Copia apenas os pixels que estão dentro da imagem (os blocos da borda podem sobrar).
+            for (int py = 0; py < 4 && by * 4 + py < level.height; ++py) {
+                for (int px = 0; px < 4 && bx * 4 + px < level.width; ++px) {
+                    size_t dst = (static_cast<size_t>(by * 4 + py) * level.width + (bx * 4 + px)) * 4;
+                    memcpy(&rgba[dst], pixels + (py * 4 + px) * 4, 4);
+                }
+            }
+        }
+    }
+    return rgba;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>  // min, copy, sort.
+#include <chrono>  // Durações para o sleep.
+#include <cstdint>  // int64_t.
+#include <iostream>  // Relatório no console.
+#include <thread>  // sleep_for e yield.
+#include "input.h"  // clockNowNs().
+
+// Agendamento de quadros "na última hora" (modo --baixa-latencia).
+// No laço comum a entrada lida no fim do quadro N só é usada no quadro N+1, depois de esperar um quadro
+// inteiro de renderização. Aqui, com vsync ativo, o quadro dorme até o último momento seguro antes do
+// próximo vblank e só então lê a entrada, simula e desenha. O custo do quadro é previsto a partir dos
+// últimos quadros medidos, com uma margem que cresce quando um vblank é perdido e encolhe aos poucos
+// quando tudo vai bem.
+class FrameScheduler {
+public:
+    explicit FrameScheduler(int refreshRateHz) : periodNs(1000000000LL / (refreshRateHz > 0 ? refreshRateHz : 60)) {}
+
+    // Dorme até o instante previsto para começar o próximo quadro. Retorna o instante em que acordou.
+    int64_t waitForFrameStart() {
+        int64_t now = clockNowNs();
+        if (lastVblankNs == 0)
+            return now;  // Ainda sem referência de vblank: começa imediatamente.
+
+        int64_t deadline = lastVblankNs + periodNs;
+        while (deadline <= now)
+            deadline += periodNs;  // O quadro anterior atrasou; mira no próximo vblank possível.
+        int64_t wakeNs = deadline - predictedWorkNs();
+
+        // Dorme em blocos grossos e termina com yield, porque o sleep do sistema pode passar do ponto.
+        const int64_t sleepSlackNs = 1500000;
+        if (wakeNs - now > sleepSlackNs)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(wakeNs - now - sleepSlackNs));
+        while ((now = clockNowNs()) < wakeNs)
+            std::this_thread::yield();
+
+        expectedVblankNs = deadline;
+        return now;
+    }
+
+    // Informa quanto o quadro levou (do início até o fim da renderização) e quando o vblank aconteceu.
+    void onFramePresented(int64_t frameStartNs, int64_t renderDoneNs, int64_t vblankNs) {
+        workHistory[historyIndex] = renderDoneNs - frameStartNs;
+        historyIndex = (historyIndex + 1) % historySize;
+        if (historyCount < historySize)
+            ++historyCount;
+        ++frames;
+
+        if (expectedVblankNs != 0 && vblankNs > expectedVblankNs + periodNs / 2) {
+            // Perdeu o vblank previsto: aumenta a margem de segurança.
+            ++missedFrames;
+            marginNs = marginNs + 250000 < maxMarginNs ? marginNs + 250000 : maxMarginNs;
+            framesSinceMiss = 0;
+        }
+        else if (++framesSinceMiss >= 120) {
+            // Dois segundos sem perder quadros: devolve um pouco da margem.
+            marginNs = marginNs - 50000 > minMarginNs ? marginNs - 50000 : minMarginNs;
+            framesSinceMiss = 0;
+        }
+        lastVblankNs = vblankNs;
+    }
+
+    // Custo previsto do próximo quadro: o segundo maior dos últimos quadros (aproximadamente o p95) mais a margem.
+    int64_t predictedWorkNs() const {
+        int64_t sorted[historySize];
+        std::copy(workHistory, workHistory + historyCount, sorted);
+        std::sort(sorted, sorted + historyCount);
+        int64_t recent = historyCount >= 2 ? sorted[historyCount - 2] : (historyCount == 1 ? sorted[0] : periodNs / 2);
+        return std::min(recent + marginNs, periodNs);
+    }
+
+    void report(std::ostream& out) const {
+        out << "Agendamento de baixa latência: " << missedFrames << " vblanks perdidos em " << frames << " quadros, "
+            << "custo previsto " << predictedWorkNs() / 1e6 << " ms de " << periodNs / 1e6 << " ms por quadro." << std::endl;
+    }
+
+private:
+    static const int historySize = 32;  // Quadros usados na previsão.
+    const int64_t minMarginNs = 500000;  // 0,5 ms.
+    const int64_t maxMarginNs = 4000000;  // 4 ms.
+
+    const int64_t periodNs;  // Intervalo entre vblanks.
+    int64_t lastVblankNs = 0;
+    int64_t expectedVblankNs = 0;
+    int64_t marginNs = minMarginNs;
+    int64_t workHistory[historySize] = {};
+    int historyIndex = 0;
+    int historyCount = 0;
+    int framesSinceMiss = 0;
+    int64_t frames = 0;
+    int64_t missedFrames = 0;
+};
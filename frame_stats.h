@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>  // int64_t, uint64_t.
+#include <iomanip>  // Formatação do relatório.
+#include <iostream>  // Relatório no console.
+#include <string>  // Nome dos arquivos de trace.
+#include <vector>  // Contadores do histograma.
+#include "profiler.h"  // Trace em volta de cada engasgo (com PERFILADOR).
+#ifdef _MSC_VER
+#include <intrin.h>  // _BitScanReverse64.
+#endif
+
+// Histograma de grande faixa dinâmica (no estilo do HdrHistogram) para durações em nanossegundos.
+// Valores até 255 ns ficam em baldes exatos; acima disso cada potência de 2 é dividida em 128 baldes,
+// o que mantém o erro relativo abaixo de 0,8% de 1 ns até minutos. record() é O(1) e não aloca.
+class HdrHistogram {
+public:
+    HdrHistogram() : counts(bucketCount, 0) {}
+
+    void record(int64_t valueNs) {
+        uint64_t value = valueNs > 0 ? static_cast<uint64_t>(valueNs) : 0;
+        ++counts[indexOf(value)];
+        ++total;
+        maxValue = value > maxValue ? value : maxValue;
+    }
+
+    uint64_t count() const {
+        return total;
+    }
+
+    uint64_t max() const {
+        return maxValue;
+    }
+
+    // Menor valor v tal que pelo menos p% das amostras são <= v (limite superior do balde).
+    uint64_t percentile(double p) const {
+        if (total == 0)
+            return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+        rank = rank < 1 ? 1 : rank;
+        uint64_t cumulative = 0;
+        for (int i = 0; i < bucketCount; ++i) {
+            cumulative += counts[i];
+            if (cumulative >= rank)
+                return highestValueOf(i) < maxValue ? highestValueOf(i) : maxValue;
+        }
+        return maxValue;
+    }
+
+private:
+    static const int subBucketBits = 8;
+    static const int subBucketCount = 1 << subBucketBits;  // 256 baldes exatos no início.
+    static const int subBucketHalf = subBucketCount / 2;  // 128 baldes por potência de 2 depois disso.
+    static const int bucketCount = (64 - subBucketBits + 1) * subBucketHalf + subBucketHalf;
+
+    static int highestBit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    static int indexOf(uint64_t value) {
+        if (value < static_cast<uint64_t>(subBucketCount))
+            return static_cast<int>(value);
+        int shift = highestBit(value) - (subBucketBits - 1);
+        return shift * subBucketHalf + static_cast<int>(value >> shift);
+    }
+
+    static uint64_t highestValueOf(int index) {
+        if (index < subBucketCount)
+            return static_cast<uint64_t>(index);
+        int shift = index / subBucketHalf - 1;
+        uint64_t sub = static_cast<uint64_t>(index - shift * subBucketHalf);
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+};
+
+// Tempos de quadro e de passo de simulação, com detecção de engasgos: um quadro que leva mais que o dobro
+// da mediana. A média de FPS esconde esses quadros, que são justamente os que o jogador percebe.
+// Com PERFILADOR, cada engasgo gera um trace (engasgo-N.json) de meio segundo antes a meio segundo depois.
+class FrameStats {
+public:
+    // Registra um quadro que terminou em nowNs, com a duração do quadro e da simulação (ticks passos).
+    void onFrame(int64_t nowNs, int64_t frameNs, int64_t simulationNs, int ticks) {
+        frames.record(frameNs);
+        if (ticks > 0)
+            tickTimes.record(simulationNs / ticks);
+
+        // A mediana muda devagar: recalculá-la a cada 60 quadros basta.
+        if (frames.count() % 60 == 0)
+            medianNs = static_cast<int64_t>(frames.percentile(50));
+
+        if (skipNextFrame) {
+            skipNextFrame = false;  // Quadro em que o trace anterior foi gravado: não conta como engasgo.
+        }
+        else if (frames.count() > 120 && frameNs > 2 * medianNs) {
+            ++stutters;
+            worstStutterNs = frameNs > worstStutterNs ? frameNs : worstStutterNs;
+#ifdef PERFILADOR
+            if (captureUntilNs == 0 && captures < maxCaptures) {
+                captureFromNs = nowNs - frameNs - captureMarginNs;
+                captureUntilNs = nowNs + captureMarginNs;
+                captureStutterNs = frameNs;
+            }
+#endif
+        }
+
+#ifdef PERFILADOR
+        // Espera o fim da janela para que o trace inclua o que aconteceu depois do engasgo.
+        if (captureUntilNs != 0 && nowNs >= captureUntilNs) {
+            std::string path = "engasgo-" + std::to_string(++captures) + ".json";
+            if (Profiler::instance().dump(path, captureFromNs, captureUntilNs))
+                std::cout << "Engasgo de " << captureStutterNs / 1e6 << " ms: trace gravado em " << path << std::endl;
+            captureUntilNs = 0;
+            skipNextFrame = true;
+        }
+#else
+        (void)nowNs;
+#endif
+    }
+
+    void report(std::ostream& out) const {
+        out << "Tempos                         p50      p99    p99.9      max" << std::endl;
+        printLine(out, "quadro (ms)              ", frames, 1e6);
+        printLine(out, "passo de simulação (us)  ", tickTimes, 1e3);
+        out << "Engasgos (quadro > 2x mediana): " << stutters << " em " << frames.count() << " quadros";
+        if (stutters > 0)
+            out << ", o pior com " << worstStutterNs / 1e6 << " ms";
+        out << "." << std::endl;
+    }
+
+private:
+    static void printLine(std::ostream& out, const char* name, const HdrHistogram& histogram, double unitNs) {
+        const std::streamsize precision = out.precision();
+        out << name << std::fixed << std::setprecision(3)
+            << std::setw(9) << histogram.percentile(50) / unitNs << std::setw(9) << histogram.percentile(99) / unitNs
+            << std::setw(9) << histogram.percentile(99.9) / unitNs << std::setw(9) << histogram.max() / unitNs << std::endl;
+        out.unsetf(std::ios::floatfield);
+        out.precision(precision);
+    }
+
+    HdrHistogram frames;
+    HdrHistogram tickTimes;  // Média por passo em cada quadro.
+    int64_t medianNs = 0;
+    int64_t stutters = 0;
+    int64_t worstStutterNs = 0;
+    bool skipNextFrame = false;
+#ifdef PERFILADOR
+    static const int maxCaptures = 20;  // Limite de arquivos por execução.
+    const int64_t captureMarginNs = 500000000;  // Meio segundo antes e depois.
+    int64_t captureFromNs = 0;
+    int64_t captureUntilNs = 0;  // 0: nenhuma captura pendente.
+    int64_t captureStutterNs = 0;  // Duração do quadro que abriu a captura pendente.
+    int captures = 0;
+#endif
+};
@@ -0,0 +1,736 @@
+#pragma once
+
+#include <GL/glew.h>  // Biblioteca para facilitar o uso de extensões do OpenGL.
+#include <cmath>  // INFINITY.
+#include <condition_variable>  // Acorda a thread do LevelPrefetcher.
+#include <cstdint>  // Tipos inteiros de tamanho fixo.
+#include <mutex>  // Fila de blocos da fase entre as threads.
+#include "texture.h"  // TextureHandle do pássaro.
+#include "collision_mask.h"  // Colisão pelos pixels do sprite.
+#include "input.h"  // InputAction.
+#include "profiler.h"  // Zonas do perfilador.
+
+// A simulação avança em passos fixos, independentes da taxa de quadros. As constantes de Bird e Pipe são
+// por passo e foram ajustadas no laço original (um passo por quadro, sem limite de FPS).
+const int ticks_per_second = 2000;  // Passos de simulação por segundo.
+const int64_t tick_duration_ns = 1000000000LL / ticks_per_second;  // Duração de um passo em nanossegundos.
+const float pipe_speed = 0.05f;  // Deslocamento dos tubos por passo, em pixels.
+const int max_advance_ticks = 200;  // Maior World::advance(): a parábola do pássaro se afasta da reta em até g*n²/8 = 0,5 pixel.
+
+// Gerador pseudoaleatório do jogo (xorshift32). Ao contrário de rand(), tem estado explícito: a mesma
+// semente produz a mesma sequência em qualquer plataforma, o que permite gravar e reproduzir partidas.
+struct GameRng {
+    uint32_t state;
+
+    explicit GameRng(uint32_t seed) {
+        // Mistura a semente para que sementes próximas (ou zero) gerem sequências bem diferentes.
+        uint32_t z = seed + 0x9E3779B9u;
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        state = (z ^ (z >> 16)) | 1u;
+    }
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+// Intervalo aberto (t0, t1) de instantes em que a + b * t fica entre lo e hi (que podem ser infinitos).
+// Retorna false se ele for vazio.
+inline bool sweptInterval(float a, float b, float lo, float hi, float& t0, float& t1) {
+    if (b == 0.0f) {
+        t0 = -INFINITY;
+        t1 = INFINITY;
+        return a > lo && a < hi;
+    }
+    float enter = (lo - a) / b, exit = (hi - a) / b;
+    t0 = enter < exit ? enter : exit;
+    t1 = enter < exit ? exit : enter;
+    return true;
+}
+
+// Estrutura que define o pássaro do jogo.
+struct Bird {
+    float x, y;  // Posição do pássaro.
+    float velocity;  // Velocidade vertical do pássaro.
+    TextureHandle texture;  // Textura associada ao pássaro (provisória enquanto carrega).
+    const CollisionMask* mask;  // Pixels sólidos do sprite; nullptr colide como o quadrado 30x30 inteiro.
+    const float gravity = -0.0001f;  // Constante para gravidade.
+    const float flapStrength = 0.1f;  // Força do "batimento de asas".
+
+    // Construtor que inicializa o pássaro na posição inicial. A textura é atribuída por quem desenha;
+    // sem ela (simulação sem janela) o pássaro funciona normalmente.
+    Bird() : x(100.0f), y(300.0f), velocity(0.0f), mask(nullptr) {}
+
+    // Reinicia o pássaro para a posição inicial.
+    void reset() {
+        x = 100.0f;
+        y = 300.0f;
+        velocity = 0.0f;
+    }
+
+    // Atualiza a posição do pássaro de acordo com a gravidade e a velocidade.
+    void update() {
+        velocity += gravity;  // Acelera pela gravidade.
+        y += velocity;  // Atualiza a posição vertical.
+
+        // Evita que o pássaro caia abaixo do chão.
+        if (y < 0.0f) {
+            y = 0.0f;
+            velocity = 0.0f;
+        }
+    }
+
+    // Aplica a força de "batimento de asas" ao pássaro.
+    void flap() {
+        velocity = flapStrength;
+    }
+
+    // Desenha o pássaro usando OpenGL.
+    void draw() const {
+        glBindTexture(GL_TEXTURE_2D, texture.get());  // Vincula a textura do pássaro.
+        glColor3f(1.0f, 1.0f, 1.0f);  // Define a cor como branca.
+
+        // Desenha um quadrado na posição do pássaro.
+        glBegin(GL_QUADS);
+        glTexCoord2f(0.0f, 0.0f); glVertex2f(x - 15.0f, y - 15.0f);
+        glTexCoord2f(1.0f, 0.0f); glVertex2f(x + 15.0f, y - 15.0f);
+        glTexCoord2f(1.0f, 1.0f); glVertex2f(x + 15.0f, y + 15.0f);
+        glTexCoord2f(0.0f, 1.0f); glVertex2f(x - 15.0f, y + 15.0f);
+        glEnd();
+    }
+};
+
+// Estrutura que define os tubos (obstáculos) do jogo.
+struct Pipe {
+    float x, height;  // Posição e altura do tubo.
+    bool passed;  // Indica se o pássaro já passou pelo tubo.
+
+    // Construtor que inicializa o tubo na posição e altura fornecidas.
+    Pipe(float startX, float h) : x(startX), height(h), passed(false) {}
+    Pipe() : Pipe(0.0f, 0.0f) {}
+
+    // Reinicia o tubo na posição e altura fornecidas.
+    void reset(float startX, float h) {
+        x = startX;
+        height = h;
+        passed = false;
+    }
+
+    // Atualiza a posição do tubo (movendo-se da direita para a esquerda).
+    void update(float speed, GameRng& rng) {
+        x -= speed;  // Move o tubo para a esquerda.
+
+        // Se o tubo sair da tela, reinicializa-o em uma nova posição com nova altura.
+        if (x < -50.0f) {
+            x = 800.0f;
+            height = static_cast<float>(rng.next() % 300 + 100);  // Altura aleatória.
+            passed = false;
+        }
+    }
+
+    // Desenha o tubo usando OpenGL.
+    void draw() const {
+        glColor3f(0.0f, 1.0f, 0.0f);  // Define a cor do tubo como verde.
+
+        // Desenha a parte inferior do tubo.
+        glBegin(GL_QUADS);
+        glVertex2f(x - 25.0f, 0.0f);
+        glVertex2f(x + 25.0f, 0.0f);
+        glVertex2f(x + 25.0f, height);
+        glVertex2f(x - 25.0f, height);
+        glEnd();
+
+        // Desenha a parte superior do tubo.
+        glBegin(GL_QUADS);
+        glVertex2f(x - 25.0f, 600.0f);
+        glVertex2f(x + 25.0f, 600.0f);
+        glVertex2f(x + 25.0f, height + 200.0f);
+        glVertex2f(x - 25.0f, height + 200.0f);
+        glEnd();
+    }
+
+    // Verifica se o pássaro colidiu com o tubo. O teste de caixa descarta quase todos os casos; só quando
+    // o quadrado do pássaro toca o tubo os pixels da máscara são conferidos.
+    bool isColliding(const Bird& bird) const {
+        bool boxes = (bird.x + 15.0f > x - 25.0f && bird.x - 15.0f < x + 25.0f &&
+            (bird.y - 15.0f < height || bird.y + 15.0f > height + 200.0f));
+        return boxes && (!bird.mask || bird.mask->overlapsPipe(bird.x, bird.y, x, height));
+    }
+
+    // Teste contínuo durante um passo em que o pássaro foi de birdY0 a birdY1 e o tubo de pipeX0 até x
+    // (movimentos lineares). Retorna em enter o instante exato do primeiro contato entre as caixas (0 a 1)
+    // e em exit o da separação; false se elas não se tocam no passo.
+    bool sweep(float birdX, float birdY0, float birdY1, float pipeX0, float& enter, float& exit) const {
+        // No referencial do tubo, o centro do pássaro percorre um segmento; as caixas se tocam quando ele
+        // está dentro de um dos retângulos do tubo aumentados pela metade do pássaro.
+        float tx0, tx1, ty0, ty1;
+        if (!sweptInterval(birdX - pipeX0, pipeX0 - x, -40.0f, 40.0f, tx0, tx1))
+            return false;
+        enter = 2.0f;
+        exit = -1.0f;
+        const float dy = birdY1 - birdY0;
+        if (sweptInterval(birdY0, dy, -INFINITY, height + 15.0f, ty0, ty1)) {  // Tubo de baixo.
+            float t0 = tx0 > ty0 ? tx0 : ty0, t1 = tx1 < ty1 ? tx1 : ty1;
+            t0 = t0 > 0.0f ? t0 : 0.0f;
+            t1 = t1 < 1.0f ? t1 : 1.0f;
+            if (t0 < t1) {
+                enter = t0;
+                exit = t1;
+            }
+        }
+        if (sweptInterval(birdY0, dy, height + 185.0f, INFINITY, ty0, ty1)) {  // Tubo de cima.
+            float t0 = tx0 > ty0 ? tx0 : ty0, t1 = tx1 < ty1 ? tx1 : ty1;
+            t0 = t0 > 0.0f ? t0 : 0.0f;
+            t1 = t1 < 1.0f ? t1 : 1.0f;
+            if (t0 < t1 && t0 < enter) {
+                enter = t0;
+                exit = t1;
+            }
+        }
+        return enter <= 1.0f;
+    }
+
+    // Colisão em algum instante do passo (ver sweep). Com máscara, os pixels são conferidos em pontos a no
+    // máximo um pixel de distância ao longo do trecho em que as caixas se sobrepõem.
+    bool isCollidingSwept(const Bird& bird, float birdY0, float pipeX0) const {
+        float enter, exit;
+        if (!sweep(bird.x, birdY0, bird.y, pipeX0, enter, exit))
+            return false;
+        if (!bird.mask)
+            return true;
+        const float dx = x - pipeX0, dy = bird.y - birdY0;
+        const float distance = ((dx < 0.0f ? -dx : dx) + (dy < 0.0f ? -dy : dy)) * (exit - enter);
+        const int samples = 1 + static_cast<int>(distance < 256.0f ? distance : 256.0f);
+        for (int i = 0; i < samples; ++i) {
+            float t = enter + (exit - enter) * (i + 0.5f) / samples;
+            if (bird.mask->overlapsPipe(bird.x, birdY0 + dy * t, pipeX0 + dx * t, height))
+                return true;
+        }
+        return false;
+    }
+};
+
+// Os tubos andam todos à mesma velocidade e entram sempre à direita de todos os outros, então a ordem deles
+// por x nunca muda: é uma fila circular que começa no tubo mais à esquerda (head), e só os primeiros da fila
+// saem da tela. Com ela, cada pássaro testa só os tubos cuja faixa de x encosta na sua, achados por busca
+// binária, em vez de todos. Não é dona dos tubos: pipes e head ficam no World.
+class PipeRing {
+public:
+    // Os count tubos de pipes[head] em diante (circularmente, em um vetor de capacity tubos, ou count se
+    // capacity for 0) devem estar em ordem crescente de x.
+    PipeRing(Pipe* pipes, int count, int& head, int capacity = 0)
+        : pipes(pipes), count(count), capacity(capacity > 0 ? capacity : count), head(head) {}
+
+    int size() const { return count; }
+    int index(int position) const { return (head + position) % capacity; }  // Posição na fila -> índice em pipes.
+    Pipe& at(int position) const { return pipes[index(position)]; }
+
+    // Primeira posição com o centro do tubo à direita de xMin.
+    int lowerBound(float xMin) const {
+        int first = 0, last = count;
+        while (first < last) {
+            int middle = (first + last) / 2;
+            if (at(middle).x > xMin)
+                last = middle;
+            else
+                first = middle + 1;
+        }
+        return first;
+    }
+
+private:
+    Pipe* pipes;
+    int count;
+    int capacity;
+    int& head;
+};
+
+// Margem, em x, entre o centro de um pássaro e o de um tubo além da qual eles não se tocam (metade do
+// pássaro mais metade do tubo, e um pixel para arredondamentos).
+const float pipe_reach = 15.0f + 25.0f + 1.0f;
+
+// Função que reinicia o jogo, resetando o pássaro e os tubos.
+inline void resetGame(Bird& bird, Pipe pipes[]) {
+    bird.reset();
+    pipes[0].reset(400.0f, 300.0f);
+    pipes[1].reset(650.0f, 250.0f);
+    pipes[2].reset(900.0f, 350.0f);
+}
+
+const int max_pipes = 32;  // Capacidade da fila de tubos da fase contínua.
+
+// Como a fase é gerada. Na fase original (endless = false) são três tubos que voltam para x = 800 ao sair
+// da tela, com a distância entre eles fixada pelas posições iniciais; é o padrão e o das gravações antigas.
+// Na fase contínua os tubos são gerados à frente da tela em blocos de chunk tubos, quando o último entra na
+// tela, e cada um fica em uma posição da fila circular World::pipes, reaproveitada quando ele sai: partidas
+// de milhões de tubos usam sempre a mesma memória, sem alocações.
+struct LevelConfig {
+    bool endless = false;
+    float minSpacing = 200.0f, maxSpacing = 350.0f;  // Distância entre os centros de tubos seguidos, sorteada.
+    int minHeight = 100, maxHeight = 399;  // Altura da abertura (topo do tubo de baixo), sorteada.
+    int maxStep = 0;  // Maior variação da altura de um tubo para o seguinte; 0: alturas independentes.
+    int chunk = 4;  // Tubos gerados de cada vez.
+    bool reachable = true;  // Só aceita tubos alcançáveis a partir do anterior (LevelGenerator).
+
+    // Ajusta valores fora dos limites. Quando o último tubo entra na tela há no máximo 15 na fila (com a
+    // distância mínima de 60 pixels), então um bloco de até metade da fila sempre cabe.
+    void clamp() {
+        minSpacing = minSpacing < 60.0f ? 60.0f : minSpacing;
+        maxSpacing = maxSpacing < minSpacing ? minSpacing : maxSpacing;
+        minHeight = minHeight < 0 ? 0 : minHeight;
+        maxHeight = maxHeight < minHeight ? minHeight : maxHeight;
+        maxStep = maxStep < 0 ? 0 : maxStep;
+        chunk = chunk < 1 ? 1 : (chunk > max_pipes / 2 ? max_pipes / 2 : chunk);
+    }
+
+    // Sorteia a distância até o próximo tubo e a altura dele, nessa ordem.
+    float drawSpacing(GameRng& rng) const {
+        return minSpacing + (maxSpacing - minSpacing) * (rng.next() % 1024) / 1023.0f;
+    }
+
+    float drawHeight(GameRng& rng, float lastHeight) const {
+        if (maxStep > 0) {
+            int height = static_cast<int>(lastHeight) + static_cast<int>(rng.next() % (2 * maxStep + 1)) - maxStep;
+            return static_cast<float>(height < minHeight ? minHeight : (height > maxHeight ? maxHeight : height));
+        }
+        return static_cast<float>(minHeight + static_cast<int>(rng.next() % (maxHeight - minHeight + 1)));
+    }
+};
+
+// Tubos de um bloco da fase contínua, cada um dado pela distância ao anterior e pela altura.
+struct LevelChunk {
+    int count = 0;
+    float spacing[max_pipes / 2];
+    float height[max_pipes / 2];
+};
+
+// Gera a fase contínua validando o alcance: cada tubo novo é conferido contra o envelope das alturas que
+// o pássaro consegue alcançar a partir da abertura anterior, calculado passo a passo com a física de
+// Bird::update. A borda de cima do envelope bate as asas a cada passo (a subida mais rápida possível); a de
+// baixo nunca bate (a queda mais rápida). Dentro da coluna de um tubo o envelope é cortado pela abertura
+// (com um pixel de folga); uma borda cortada segue a abertura, como um pássaro que se mantém rente a ela com
+// batidas curtas. Supõe-se que toda altura entre as bordas é alcançável. Se o envelope se esvazia, a altura
+// sorteada é descartada e sorteada de novo (até 8 vezes); por fim o tubo repete a altura do anterior, que
+// sempre dá para atravessar.
+// A sequência depende só da semente e das reinicializações, não de quando os blocos são gerados: a mesma
+// partida sai igual com o LevelPrefetcher (blocos adiantados em outra thread) ou sem ele (replay.h).
+class LevelGenerator {
+public:
+    explicit LevelGenerator(const LevelConfig& config = LevelConfig(), uint32_t seed = 0)
+        : config(config), rng(seed ^ 0xA511E9B3u) {
+        this->config.clamp();
+    }
+
+    // Começo de partida: o pássaro parado em bird e só o primeiro tubo na fase. O sorteio continua de onde
+    // parou, como o rng do World.
+    void restart(const Bird& bird, const Pipe& first) {
+        birdX = bird.x;
+        lowY = highY = bird.y;
+        lowVelocity = bird.velocity;
+        pipes = 1;
+        pipeX[0] = first.x;
+        pipeHeight[0] = first.height;
+        lastHeight = first.height;
+        ++restarts;
+        chunks = 0;
+    }
+
+    // Identifica o próximo bloco: dois geradores com o mesmo par geram o mesmo bloco.
+    uint64_t restartCount() const { return restarts; }
+    uint64_t chunkIndex() const { return chunks; }
+
+    void nextChunk(LevelChunk& chunk) {
+        chunk.count = config.chunk;
+        for (int i = 0; i < config.chunk; ++i) {
+            const float spacing = config.drawSpacing(rng);
+            float height = config.drawHeight(rng, lastHeight);
+            for (int attempt = 1; !advance(spacing, height, false); ++attempt)
+                height = attempt < 8 ? config.drawHeight(rng, lastHeight) : lastHeight;
+            advance(spacing, height, true);
+            chunk.spacing[i] = spacing;
+            chunk.height[i] = height;
+        }
+        ++chunks;
+    }
+
+private:
+    // Simula o envelope da origem até o pássaro sair da coluna de um tubo novo, spacing pixels depois do
+    // último, com a abertura em height. Retorna false se ele se esvazia. Com commit, muda a origem para o
+    // instante em que o pássaro entra na coluna do tubo novo e o acrescenta à fase.
+    bool advance(float spacing, float height, bool commit) {
+        const float x = pipeX[pipes - 1] + spacing;
+        const int enter = static_cast<int>((x - birdX - pipe_reach) / pipe_speed);
+        const int exit = static_cast<int>((x - birdX + pipe_reach) / pipe_speed) + 1;
+        Bird high, low;
+        high.y = highY;
+        low.y = lowY;
+        low.velocity = lowVelocity;
+        for (int tick = 1; tick <= exit; ++tick) {
+            if (commit && tick == enter + 1) {
+                highY = high.y;  // O estado antes do passo enter + 1 é o da nova origem.
+                lowY = low.y;
+                lowVelocity = low.velocity;
+            }
+            high.flap();
+            high.update();
+            low.update();
+            const float offset = tick * pipe_speed;
+            for (int i = 0; i <= pipes; ++i) {
+                const float pipeCenter = (i < pipes ? pipeX[i] : x) - offset;
+                if (pipeCenter - birdX >= pipe_reach || birdX - pipeCenter >= pipe_reach)
+                    continue;
+                const float gapHeight = i < pipes ? pipeHeight[i] : height;
+                if (low.y < gapHeight + 16.0f) {
+                    low.y = gapHeight + 16.0f;
+                    low.velocity = 0.0f;
+                }
+                if (high.y > gapHeight + 184.0f)
+                    high.y = gapHeight + 184.0f;
+            }
+            if (high.y < low.y)
+                return false;
+        }
+        if (commit) {
+            // Novo referencial: tubos na posição do instante enter; os que já ficaram para trás saem.
+            const float offset = enter * pipe_speed;
+            int kept = 0;
+            for (int i = 0; i < pipes; ++i) {
+                if (pipeX[i] - offset > birdX - pipe_reach) {
+                    pipeX[kept] = pipeX[i] - offset;
+                    pipeHeight[kept++] = pipeHeight[i];
+                }
+            }
+            pipeX[kept] = x - offset;
+            pipeHeight[kept] = height;
+            pipes = kept + 1;
+            lastHeight = height;
+        }
+        return true;
+    }
+
+    LevelConfig config;
+    GameRng rng;
+    float birdX = 100.0f;
+    float lowY = 300.0f, lowVelocity = 0.0f;  // Borda de baixo do envelope na origem (sem bater as asas).
+    float highY = 300.0f;  // Borda de cima (batendo as asas a cada passo).
+    float pipeX[4] = {}, pipeHeight[4] = {};  // Tubos cuja coluna ainda não acabou, no referencial da origem.
+    int pipes = 0;
+    float lastHeight = 300.0f;
+    uint64_t restarts = 0, chunks = 0;
+};
+
+// Blocos da fase gerados à frente por outra thread (LevelPrefetcher, level_prefetcher.h) para o World
+// consumir sem esperar. Além dos próximos blocos, a thread deixa prontos os dois primeiros blocos de uma
+// partida recomeçada a partir do estado atual do World, para que reiniciar também não gere nada no laço (com
+// tubos próximos, o segundo bloco é pedido logo no passo seguinte ao recomeço).
+// Capacidade fixa: nem o World nem a thread alocam memória.
+class LevelChunkQueue {
+public:
+    static const int capacity = 4;
+
+    // Chamado pelo World: copia em chunk o próximo bloco de generator e avança generator, se ele já foi
+    // gerado. Senão (thread atrasada) retorna false e o World o gera e chama restart.
+    bool take(LevelGenerator& generator, LevelChunk& chunk) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (count == 0 || entries[first].restarts != generator.restartCount() || entries[first].index != generator.chunkIndex()) {
+            ++misses;
+            return false;
+        }
+        chunk = entries[first].chunk;
+        generator = entries[first].after;
+        current = generator;
+        hasRestartEntry = false;  // Era para o estado anterior.
+        first = (first + 1) % capacity;
+        --count;
+        ++hits;
+        wake.notify_one();
+        return true;
+    }
+
+    // Chamado pelo World ao recomeçar a partida (World::resetLevel): como generator.restart seguido de take,
+    // com os blocos que a thread preparou para o estado atual de generator. O segundo bloco passa a ser o
+    // próximo da fila. Retorna false se eles não estiverem prontos; o World segue então pelo caminho normal
+    // (e take conta a falta).
+    bool takeRestart(LevelGenerator& generator, LevelChunk& chunk) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!hasRestartEntry || restartEntry.first.restarts != generator.restartCount() ||
+            restartEntry.first.index != generator.chunkIndex())
+            return false;
+        chunk = restartEntry.first.chunk;
+        generator = restartEntry.first.after;
+        current = generator;
+        entries[first] = restartEntry.second;
+        producer = restartEntry.second.after;
+        count = 1;
+        hasRestartEntry = false;
+        ++epoch;  // Descarta o que a thread estiver gerando para a partida anterior.
+        ++hits;
+        wake.notify_one();
+        return true;
+    }
+
+    // Descarta os blocos adiantados e faz a thread continuar a partir de generator.
+    void restart(const LevelGenerator& generator) {
+        std::lock_guard<std::mutex> lock(mutex);
+        producer = current = generator;
+        hasProducer = true;
+        hasRestartEntry = false;
+        ++epoch;
+        count = 0;
+        wake.notify_one();
+    }
+
+    uint64_t hitCount() const { std::lock_guard<std::mutex> lock(mutex); return hits; }
+    uint64_t missCount() const { std::lock_guard<std::mutex> lock(mutex); return misses; }
+
+private:
+    friend class LevelPrefetcher;
+
+    struct Entry {
+        uint64_t restarts = 0, index = 0;  // Do gerador antes do bloco.
+        LevelChunk chunk;
+        LevelGenerator after;
+    };
+
+    // Os dois primeiros blocos de uma partida recomeçada a partir de um estado (first.restarts, first.index).
+    struct RestartEntry {
+        Entry first, second;
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    Entry entries[capacity];
+    int first = 0, count = 0;
+    LevelGenerator producer;  // Estado da thread depois do último bloco na fila.
+    LevelGenerator current;  // Estado do World (antes de entries[first]).
+    RestartEntry restartEntry;  // Recomeço a partir de current, válido com hasRestartEntry.
+    bool hasRestartEntry = false;
+    bool hasProducer = false;
+    uint64_t epoch = 0;  // Muda a cada restart e takeRestart, para a thread descartar um bloco gerado antes deles.
+    bool stopping = false;
+    uint64_t hits = 0, misses = 0;
+};
+
+// Estado completo de uma partida. A mesma semente, a mesma fase e as mesmas ações nos mesmos passos levam
+// sempre ao mesmo estado, seja no jogo com janela, seja na reprodução sem janela (replay.h).
+struct World {
+    Bird bird;
+    Pipe pipes[max_pipes];  // Fila circular; a fase original usa só as três primeiras posições.
+    int pipeCount;  // Tubos na fila.
+    int firstPipe;  // Começo da fila (o tubo mais à esquerda).
+    LevelConfig level;
+    LevelGenerator generator;  // Fase contínua com validação de alcance.
+    LevelChunkQueue* chunks = nullptr;  // Blocos adiantados pelo LevelPrefetcher; nullptr gera na hora.
+    bool gameOver;
+    int score;  // Tubos ultrapassados na partida atual.
+    GameRng rng;
+    int64_t tick;  // Passos de simulação já executados.
+
+    explicit World(uint32_t seed, const LevelConfig& config = LevelConfig())
+        : level(config), generator(config, seed), gameOver(false), score(0), rng(seed), tick(0) {
+        level.clamp();
+        resetLevel();
+    }
+
+    // O tubo na posição position da fila (0 é o mais à esquerda).
+    Pipe& pipe(int position) { return pipes[(firstPipe + position) % pipeCapacity()]; }
+    const Pipe& pipe(int position) const { return pipes[(firstPipe + position) % pipeCapacity()]; }
+    int pipeCapacity() const { return level.endless ? max_pipes : 3; }
+
+    // Primeiro tubo da fase contínua. Toda partida começa com ele e com o pássaro em Bird() (o de
+    // Bird::reset()), o que permite ao LevelPrefetcher preparar o bloco de uma partida recomeçada.
+    static Pipe firstEndlessPipe() { return Pipe(400.0f, 300.0f); }
+
+    // Aplica uma ação do jogador antes do próximo passo. Retorna true se ela teve efeito.
+    bool apply(InputAction action) {
+        if (action == InputAction::Flap && !gameOver) {
+            bird.flap();  // O pássaro "bate as asas".
+            return true;
+        }
+        if (action == InputAction::Reset && gameOver) {
+            // Se o jogo terminou, a tecla "R" reinicia.
+            bird.reset();
+            resetLevel();
+            gameOver = false;
+            score = 0;
+            return true;
+        }
+        return false;
+    }
+
+    // Executa um passo de simulação.
+    void step() {
+        // Se o jogo não terminou, atualiza o estado do pássaro e tubos.
+        if (!gameOver) {
+            const float birdY0 = bird.y;
+            {
+                PROFILE_ZONE("Bird::update");
+                bird.update();  // Atualiza o pássaro.
+            }
+            PROFILE_ZONE("Pipe::update/isColliding");
+            updatePipes(pipe_speed, birdY0, false);
+        }
+        ++tick;
+    }
+
+    // Avança ticks passos (até max_advance_ticks) de uma vez, para execuções sem janela de alto desempenho.
+    // O pássaro usa a forma fechada de ticks chamadas a Bird::update() e os tubos andam ticks * pipe_speed;
+    // com mais de um passo a colisão é contínua (com o caminho do pássaro aproximado por uma reta), então
+    // nenhum tubo é atravessado. O resultado é próximo, mas não igual bit a bit, ao de ticks chamadas a step().
+    void advance(int ticks) {
+        if (!gameOver) {
+            const float n = static_cast<float>(ticks);
+            const float birdY0 = bird.y;
+            bird.y += n * bird.velocity + bird.gravity * n * (n + 1.0f) / 2.0f;
+            bird.velocity += n * bird.gravity;
+            if (bird.y < 0.0f) {
+                bird.y = 0.0f;  // Como em Bird::update(): parado no chão.
+                bird.velocity = 0.0f;
+            }
+            updatePipes(n * pipe_speed, birdY0, ticks > 1);
+        }
+        tick += ticks;
+    }
+
+    // Hash FNV-1a do estado da partida, usado para verificar se uma reprodução chegou ao mesmo resultado.
+    uint64_t hash() const {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i)
+                h = (h ^ bytes[i]) * 1099511628211ull;
+        };
+        mix(&bird.x, sizeof(float));
+        mix(&bird.y, sizeof(float));
+        mix(&bird.velocity, sizeof(float));
+        for (int i = 0; i < pipeCapacity(); ++i) {  // Em ordem de índice, como antes da fila.
+            mix(&pipes[i].x, sizeof(float));
+            mix(&pipes[i].height, sizeof(float));
+        }
+        unsigned char over = gameOver ? 1 : 0;
+        mix(&over, 1);
+        mix(&score, sizeof(score));
+        mix(&rng.state, sizeof(rng.state));
+        mix(&tick, sizeof(tick));
+        return h;
+    }
+
+private:
+    // Tubos do início da partida. A fase contínua começa com o mesmo primeiro tubo da original.
+    void resetLevel() {
+        firstPipe = 0;
+        if (!level.endless) {
+            resetGame(bird, pipes);
+            pipeCount = 3;
+            return;
+        }
+        for (auto& slot : pipes)
+            slot.reset(0.0f, 0.0f);
+        pipes[0] = firstEndlessPipe();
+        pipeCount = 1;
+        LevelChunk chunk;
+        if (level.reachable && chunks && chunks->takeRestart(generator, chunk)) {
+            appendChunk(chunk);
+            return;
+        }
+        generator.restart(bird, pipes[0]);
+        generateChunk();
+    }
+
+    // Gera o próximo bloco da fase contínua depois do último tubo da fila. Sem validação, sorteia na hora
+    // com o rng do World (como nas gravações da versão 3).
+    void generateChunk() {
+        LevelChunk chunk;
+        if (!level.reachable) {
+            chunk.count = level.chunk;
+            for (int i = 0; i < level.chunk; ++i) {
+                chunk.spacing[i] = level.drawSpacing(rng);
+                chunk.height[i] = level.drawHeight(rng, i > 0 ? chunk.height[i - 1] : pipe(pipeCount - 1).height);
+            }
+        }
+        else if (!chunks || !chunks->take(generator, chunk)) {
+            generator.nextChunk(chunk);
+            if (chunks)
+                chunks->restart(generator);
+        }
+        appendChunk(chunk);
+    }
+
+    // Acrescenta os tubos de chunk depois do último tubo da fila.
+    void appendChunk(const LevelChunk& chunk) {
+        for (int i = 0; i < chunk.count; ++i) {
+            const float x = pipe(pipeCount - 1).x + chunk.spacing[i];
+            pipe(pipeCount).reset(x, chunk.height[i]);
+            ++pipeCount;
+        }
+    }
+
+    // Move os tubos distance pixels. Guarda em pipeX0 a posição de cada um antes do movimento (por posição
+    // na fila) e retorna quantos saíram do começo da fila.
+    int movePipes(float distance, float pipeX0[]) {
+        for (int i = 0; i < pipeCount; ++i)
+            pipeX0[i] = pipe(i).x;
+        int removed = 0;
+        while (removed < pipeCount && pipe(removed).x - distance < -50.0f)
+            ++removed;
+
+        if (!level.endless) {
+            // Em ordem de índice, como sempre (a ordem de consumo do rng não muda). Os que saem da tela voltam
+            // para x = 800 e andam os passos que sobraram (em advance()); eles vão para o fim da fila.
+            for (int i = 0; i < 3; ++i) {
+                const float x = pipes[i].x - distance;
+                pipes[i].update(distance, rng);
+                if (x < -50.0f)
+                    pipes[i].x -= static_cast<int>((-50.0f - x) / pipe_speed) * pipe_speed;
+            }
+            firstPipe = (firstPipe + removed) % 3;
+            return removed;
+        }
+
+        for (int i = 0; i < pipeCount; ++i)
+            pipe(i).x -= distance;
+        firstPipe = (firstPipe + removed) % max_pipes;  // As posições dos que saíram ficam livres.
+        pipeCount -= removed;
+        // Quando o último tubo entra na tela, todos os da fila estão entre -50 e 800 (no máximo 15, com a
+        // distância mínima de 60 pixels), então sempre há posições livres e a fila nunca fica vazia.
+        if (pipe(pipeCount - 1).x < 800.0f)
+            generateChunk();
+        return removed;
+    }
+
+    // Move os tubos, testa a colisão com os que estão perto do pássaro e conta os ultrapassados. Com swept,
+    // testa também o caminho durante o movimento (ver advance()).
+    void updatePipes(float distance, float birdY0, bool swept) {
+        float pipeX0[max_pipes];
+        const int removed = movePipes(distance, pipeX0);
+        PipeRing ring(pipes, pipeCount, firstPipe, pipeCapacity());
+
+        // Só os tubos perto do pássaro podem colidir. Em step() só a posição final é testada: o teste
+        // contínuo acharia colisões de raspão dentro do passo que o jogo nunca teve (e as gravações antigas
+        // deixariam de conferir). Os tubos que acabaram de entrar nunca estão perto.
+        int end = ring.lowerBound(bird.x - pipe_reach);
+        for (; end < ring.size() && ring.at(end).x < bird.x + pipe_reach + distance; ++end) {
+            const Pipe& pipe = ring.at(end);
+            if (pipe.isColliding(bird) || (swept && pipe.isCollidingSwept(bird, birdY0, pipeX0[end + removed]))) {
+                gameOver = true;  // Verifica colisão com os tubos.
+            }
+        }
+        scorePipes(ring, end);
+    }
+
+    // Conta os tubos que o pássaro acabou de ultrapassar por inteiro. Da posição end em diante nenhum tubo
+    // está atrás do pássaro; para trás, a partir do primeiro já contado, todos já foram.
+    void scorePipes(const PipeRing& ring, int end) {
+        for (int i = end - 1; i >= 0 && !ring.at(i).passed; --i) {
+            Pipe& pipe = ring.at(i);
+            if (pipe.x + 25.0f < bird.x - 15.0f) {
+                pipe.passed = true;  // O pássaro passou inteiro pelo tubo.
+                ++score;
+            }
+        }
+    }
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>  // int64_t.
+#include "alloc_tracker.h"  // Alocações atribuídas à simulação.
+#include "game.h"  // World.
+#include "input.h"  // InputQueue, clockNowNs().
+#include "latency.h"  // LatencyTracker.
+#include "metrics.h"  // Métricas do jogo.
+#include "profiler.h"  // Zonas do perfilador.
+#include "replay.h"  // Gravação da partida.
+
+// Após uma pausa longa, descarta o atraso em vez de acelerar o jogo.
+const int64_t max_ticks_per_frame = ticks_per_second / 4;
+
+// Métricas do jogo exportadas para o monitoramento dos quiosques.
+struct GameMetrics {
+    MetricCounter& frames;
+    MetricHistogram& frameTime;
+    MetricCounter& games;
+    MetricHistogram& score;
+    MetricGauge& currentScore;
+
+    explicit GameMetrics(MetricsRegistry& registry)
+        : frames(registry.counter("flappy_frames_total", "Quadros desenhados.")),
+          frameTime(registry.histogram("flappy_frame_time_seconds", "Tempo entre quadros.",
+                                       { 0.001, 0.002, 0.004, 0.008, 0.0167, 0.0333, 0.05, 0.1, 0.25 })),
+          games(registry.counter("flappy_games_played_total", "Partidas terminadas.")),
+          score(registry.histogram("flappy_game_score", "Pontos por partida (soma/contagem = media).",
+                                   { 0, 1, 2, 5, 10, 20, 50, 100 })),
+          currentScore(registry.gauge("flappy_current_score", "Pontos da partida em andamento.")) {}
+};
+
+// Parte de cada quadro que não depende do OpenGL: entrada, simulação em passos fixos e métricas.
+// O laço principal a usa entre glClear e o desenho; a verificação de alocações (--verificar-alocacoes)
+// a executa sem janela, com relógio e teclas simulados.
+class GameLoop {
+public:
+    GameLoop(uint32_t seed, int64_t startNs, bool record, bool measureLatency, MetricsRegistry& registry,
+             const LevelConfig& level = LevelConfig())
+        : world(seed, level), latency(measureLatency), metrics(registry), simulationStartNs(startNs), lastFrameNs(startNs), record(record) {
+        recording.seed = seed;
+        recording.level = world.level;
+    }
+
+    // Avança a simulação em passos fixos até o passo que contém nowNs (inclusive), para que uma tecla lida
+    // logo antes deste ponto já seja aplicada neste quadro. Retorna quantos passos foram executados.
+    int simulate(int64_t nowNs) {
+        ALLOCATION_SCOPE("simulacao");
+        int64_t targetTick = (nowNs - simulationStartNs) / tick_duration_ns + 1;
+        if (targetTick - tick > max_ticks_per_frame)
+            tick = targetTick - max_ticks_per_frame;
+        const int64_t firstTick = world.tick;
+        while (tick < targetTick) {
+            PROFILE_ZONE("passo");
+            // Aplica os eventos que ocorreram até este passo, antes de atualizá-lo.
+            InputEvent event;
+            while (input.peek(event) && (event.timeNs - simulationStartNs) / tick_duration_ns <= tick) {
+                input.pop(event);
+                if (world.apply(event.action)) {
+                    if (record)
+                        recording.record(world.tick, event.action);
+                    if (event.action == InputAction::Flap)
+                        latency.onConsumed(event.timeNs, clockNowNs());
+                }
+            }
+
+            // Fim de partida registrado no passo em que acontece: num quadro longo a partida pode acabar e
+            // recomeçar (tecla de reinício) antes do fim do quadro.
+            const bool wasGameOver = world.gameOver;
+            world.step();  // Atualiza o pássaro e os tubos.
+            ++tick;
+            if (world.gameOver && !wasGameOver) {
+                metrics.games.add();
+                metrics.score.observe(world.score);
+            }
+        }
+
+        metrics.currentScore.set(world.score);
+        return static_cast<int>(world.tick - firstTick);
+    }
+
+    // Recomeça o relógio da simulação em nowNs, antes do primeiro passo: o jogo segura a partida no passo 0
+    // até a máscara de colisão do pássaro chegar. As teclas lidas antes disso são aplicadas no primeiro passo.
+    void startClock(int64_t nowNs) {
+        simulationStartNs = nowNs;
+        tick = 0;
+    }
+
+    // Fecha o quadro desenhado em nowNs. Retorna a duração do quadro.
+    int64_t endFrame(int64_t nowNs) {
+        int64_t frameNs = nowNs - lastFrameNs;
+        lastFrameNs = nowNs;
+        metrics.frames.add();
+        metrics.frameTime.observe(frameNs / 1e9);
+        return frameNs;
+    }
+
+    // Partida gravada até agora (--gravar), com o passo e o hash do estado atual.
+    const Replay& finishRecording() {
+        recording.ticks = world.tick;
+        recording.hash = world.hash();
+        recording.maskHash = world.bird.mask ? world.bird.mask->hash() : 0;
+        return recording;
+    }
+
+    World world;
+    InputQueue input;  // Teclas com carimbo de tempo, aplicadas no passo correspondente.
+    LatencyTracker latency;
+
+private:
+    GameMetrics metrics;
+    Replay recording;  // Ações aplicadas, para o --gravar.
+    int64_t simulationStartNs;
+    int64_t tick = 0;  // Próximo passo de simulação a ser executado, no relógio (world.tick não conta os passos descartados).
+    int64_t lastFrameNs;
+    const bool record;
+};
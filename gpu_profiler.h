@@ -0,0 +1,142 @@
+#pragma once
+
+#include "profiler.h"  // PROFILE_ZONE e as linhas do trace.
+
+// Tempos da GPU por etapa de renderização (opção PERFILADOR).
+// Os tempos de CPU em volta de Pipe::draw e Bird::draw só medem o envio dos comandos; o custo real de
+// desenhar (que é o que pesa com o llvmpipe) só aparece na GPU. PROFILE_GPU_ZONE("nome") grava a zona de
+// CPU e, além dela, dois GL_TIMESTAMP (glQueryCounter) no início e no fim. Os resultados são lidos alguns
+// quadros depois, quando já estão prontos, para nunca parar a CPU esperando a GPU, e entram no trace em
+// uma linha "GPU", ao lado das zonas de CPU de mesmo nome.
+// Requer GL 3.3 ou ARB_timer_query; sem isso as zonas de GPU não fazem nada.
+
+#ifdef PERFILADOR
+
+#include <GL/glew.h>  // Consultas de tempo do OpenGL.
+#include <iostream>  // Aviso quando não há suporte.
+
+class GpuProfiler {
+public:
+    static GpuProfiler& instance() {
+        static GpuProfiler profiler;
+        return profiler;
+    }
+
+    // Cria as consultas. Deve ser chamado com o contexto OpenGL atual.
+    void init() {
+        if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query) {
+            std::cerr << "GL_ARB_timer_query indisponível: o perfilador não medirá a GPU." << std::endl;
+            return;
+        }
+        for (auto& frame : frames)
+            glGenQueries(maxZones * 2, &frame.queries[0][0]);
+        track = &Profiler::instance().createTrack("GPU");
+        synchronizeClocks();
+        available = true;
+    }
+
+    // Libera as consultas. Deve ser chamado antes de destruir o contexto.
+    void release() {
+        if (!available)
+            return;
+        for (auto& frame : frames)
+            glDeleteQueries(maxZones * 2, &frame.queries[0][0]);
+        available = false;
+    }
+
+    // Começa um quadro: lê os resultados do quadro que usou este espaço do anel e o reutiliza.
+    void beginFrame() {
+        if (!available)
+            return;
+        current = (current + 1) % framesInFlight;
+        collect(frames[current]);
+        frames[current].count = 0;
+
+        // Os relógios da CPU e da GPU se afastam com o tempo: reajusta a diferença de vez em quando.
+        if (++framesSinceSync >= 240)
+            synchronizeClocks();
+    }
+
+    // Marca o início de uma zona; retorna o índice a passar para endZone (ou -1 se não for medida).
+    int beginZone(const char* name) {
+        Frame& frame = frames[current];
+        if (!available || frame.count == maxZones)
+            return -1;
+        int index = frame.count++;
+        frame.names[index] = name;
+        glQueryCounter(frame.queries[index][0], GL_TIMESTAMP);
+        return index;
+    }
+
+    void endZone(int index) {
+        if (index >= 0)
+            glQueryCounter(frames[current].queries[index][1], GL_TIMESTAMP);
+    }
+
+private:
+    static const int framesInFlight = 4;  // Quadros de atraso até a leitura dos resultados.
+    static const int maxZones = 16;  // Zonas de GPU por quadro.
+
+    struct Frame {
+        GLuint queries[maxZones][2];  // Início e fim de cada zona.
+        const char* names[maxZones];
+        int count = 0;
+    };
+
+    GpuProfiler() = default;
+
+    // Passa as zonas prontas para o trace, convertidas para o relógio da CPU. Se a GPU ainda não terminou
+    // o quadro (atraso maior que framesInFlight), descarta-o em vez de esperar.
+    void collect(const Frame& frame) {
+        if (frame.count == 0)
+            return;
+        GLint ready = 0;
+        glGetQueryObjectiv(frame.queries[frame.count - 1][1], GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (!ready)
+            return;
+        for (int i = 0; i < frame.count; ++i) {
+            GLuint64 startNs = 0, endNs = 0;
+            glGetQueryObjectui64v(frame.queries[i][0], GL_QUERY_RESULT, &startNs);
+            glGetQueryObjectui64v(frame.queries[i][1], GL_QUERY_RESULT, &endNs);
+            track->push(frame.names[i], static_cast<int64_t>(startNs) + clockOffsetNs, static_cast<int64_t>(endNs) + clockOffsetNs);
+        }
+    }
+
+    void synchronizeClocks() {
+        GLint64 gpuNowNs = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNowNs);
+        clockOffsetNs = profilerNowNs() - gpuNowNs;
+        framesSinceSync = 0;
+    }
+
+    bool available = false;
+    Frame frames[framesInFlight];
+    int current = 0;
+    ProfileThreadBuffer* track = nullptr;  // Linha "GPU" do trace.
+    int64_t clockOffsetNs = 0;  // Relógio da CPU menos relógio da GPU.
+    int framesSinceSync = 0;
+};
+
+// Mede uma zona na GPU enquanto o objeto existir.
+class GpuZone {
+public:
+    explicit GpuZone(const char* name) : index(GpuProfiler::instance().beginZone(name)) {}
+
+    ~GpuZone() {
+        GpuProfiler::instance().endZone(index);
+    }
+
+    GpuZone(const GpuZone&) = delete;
+    GpuZone& operator=(const GpuZone&) = delete;
+
+private:
+    int index;
+};
+
+#define PROFILE_GPU_ZONE(name) PROFILE_ZONE(name); GpuZone PROFILE_CONCAT(gpuZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_GPU_ZONE(name) ((void)0)
+
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <EGL/egl.h>  // Contexto OpenGL sem janela.
+#include <EGL/eglext.h>  // Plataformas surfaceless (Mesa) e de dispositivo.
+#include <cstring>  // strstr.
+
+// Contexto OpenGL sem servidor gráfico (X11 ou Wayland), para o --benchmark-render e o --verificar-texturas
+// em CI e em servidores sem monitor. Usa o EGL com a plataforma surfaceless do Mesa (llvmpipe, ou a GPU pelo
+// driver DRM) ou, sem ela, o primeiro dispositivo EGL (drivers proprietários). O desenho vai para uma
+// superfície pbuffer do tamanho da janela do jogo. Só existe no build com CONTEXTO_EGL (Linux, opção
+// automática do CMake).
+class HeadlessGlContext {
+public:
+    HeadlessGlContext() = default;
+
+    ~HeadlessGlContext() {
+        if (display == EGL_NO_DISPLAY)
+            return;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context != EGL_NO_CONTEXT)
+            eglDestroyContext(display, context);
+        if (surface != EGL_NO_SURFACE)
+            eglDestroySurface(display, surface);
+        eglTerminate(display);
+    }
+
+    HeadlessGlContext(const HeadlessGlContext&) = delete;
+    HeadlessGlContext& operator=(const HeadlessGlContext&) = delete;
+
+    // Cria o contexto (OpenGL de compatibilidade, como o da janela do GLFW) e o torna atual nesta thread.
+    bool create(int width, int height) {
+        display = openDisplay();
+        if (display == EGL_NO_DISPLAY || !eglBindAPI(EGL_OPENGL_API))
+            return false;
+        const EGLint configAttributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+                                            EGL_NONE };
+        EGLConfig config;
+        EGLint count = 0;
+        if (!eglChooseConfig(display, configAttributes, &config, 1, &count) || count < 1)
+            return false;
+        const EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+        return surface != EGL_NO_SURFACE && context != EGL_NO_CONTEXT && eglMakeCurrent(display, surface, surface, context);
+    }
+
+    // Plataforma EGL usada, para o relatório.
+    const char* platform() const { return platformName; }
+
+private:
+    EGLDisplay openDisplay() {
+        // Sem suporte a extensões de cliente, a consulta retorna nullptr.
+        const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (!extensions || !getPlatformDisplay)
+            return EGL_NO_DISPLAY;
+
+        if (strstr(extensions, "EGL_MESA_platform_surfaceless")) {
+            EGLDisplay surfaceless = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (surfaceless != EGL_NO_DISPLAY && eglInitialize(surfaceless, nullptr, nullptr)) {
+                platformName = "EGL surfaceless";
+                return surfaceless;
+            }
+        }
+        auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+        if (queryDevices && strstr(extensions, "EGL_EXT_platform_device")) {
+            EGLDeviceEXT device;
+            EGLint count = 0;
+            if (queryDevices(1, &device, &count) && count > 0) {
+                EGLDisplay deviceDisplay = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, device, nullptr);
+                if (deviceDisplay != EGL_NO_DISPLAY && eglInitialize(deviceDisplay, nullptr, nullptr)) {
+                    platformName = "EGL device";
+                    return deviceDisplay;
+                }
+            }
+        }
+        return EGL_NO_DISPLAY;
+    }
+
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLSurface surface = EGL_NO_SURFACE;
+    EGLContext context = EGL_NO_CONTEXT;
+    const char* platformName = "";
+};
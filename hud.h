@@ -0,0 +1,167 @@
+#pragma once
+
+#include <GL/glew.h>  // Buffer de vértices do OpenGL.
+#include <cstdint>  // int64_t.
+#include <cstdio>  // snprintf.
+#include "stb_easy_font.h"  // Texto montado com quadriláteros, sem textura.
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // Evita que windows.h defina min e max.
+#endif
+#include <windows.h>  // GetCurrentProcess.
+#include <psapi.h>  // GetProcessMemoryInfo.
+#elif defined(__linux__)
+#include <fcntl.h>  // open.
+#include <unistd.h>  // read, close, sysconf.
+#endif
+
+// Painel de desempenho (opção --hud): FPS, gráfico do tempo de quadro, passos de simulação por quadro,
+// chamadas de desenho e memória do processo. Todos os quadriláteros (letras do stb_easy_font e barras
+// do gráfico) vão para um único buffer de vértices, enviado e desenhado com uma chamada por quadro.
+// Não aloca memória por quadro.
+class PerformanceHud {
+public:
+    // Cria o buffer de vértices. Deve ser chamado com o contexto OpenGL atual.
+    void init() {
+        glGenBuffers(1, &vbo);
+    }
+
+    // Libera o buffer. Deve ser chamado antes de destruir o contexto.
+    void release() {
+        if (vbo)
+            glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+
+    // Registra o quadro que terminou: duração, passos de simulação executados e chamadas de desenho.
+    void frame(int64_t frameNs, int ticks, int drawCalls) {
+        frameTimes[historyIndex] = static_cast<float>(frameNs / 1e6);
+        historyIndex = (historyIndex + 1) % historySize;
+
+        // Os números mudam duas vezes por segundo, para que possam ser lidos.
+        accumulatedNs += frameNs;
+        accumulatedFrames += 1;
+        accumulatedTicks += ticks;
+        if (accumulatedNs >= 500000000LL) {
+            fps = accumulatedFrames * 1e9 / accumulatedNs;
+            averageMs = accumulatedNs / 1e6 / accumulatedFrames;
+            ticksPerFrame = static_cast<double>(accumulatedTicks) / accumulatedFrames;
+            residentBytes = readResidentBytes();
+            accumulatedNs = 0;
+            accumulatedFrames = 0;
+            accumulatedTicks = 0;
+        }
+        lastDrawCalls = drawCalls + 1;  // Inclui a chamada do próprio painel.
+    }
+
+    // Desenha o painel no canto superior esquerdo de uma janela de windowHeight pixels de altura.
+    void draw(int windowHeight) {
+        int quads = 0;
+
+        // Fundo escuro atrás do texto e do gráfico.
+        const unsigned char background[4] = { 0, 0, 0, 160 };
+        addQuad(quads++, 0.0f, 0.0f, panelWidth, panelHeight, background);
+
+        char text[256];
+        snprintf(text, sizeof(text), "FPS %.0f  (%.2f ms)\nPassos/quadro %.1f\nDesenhos %d\nMemoria %.1f MB",
+                 fps, averageMs, ticksPerFrame, lastDrawCalls, residentBytes / (1024.0 * 1024.0));
+        unsigned char white[4] = { 255, 255, 255, 255 };
+        quads += stb_easy_font_print(4.0f, 4.0f, text, white, vertices + quads * 4,
+                                     static_cast<int>((maxQuads - quads) * 4 * sizeof(HudVertex)));
+
+        // Gráfico: uma barra por quadro, do mais antigo ao mais novo, com uma linha em 16,7 ms (60 Hz).
+        const float graphTop = 44.0f, graphHeight = 40.0f, msScale = graphHeight / 33.3f;
+        const unsigned char green[4] = { 80, 255, 80, 255 }, red[4] = { 255, 80, 80, 255 }, line[4] = { 255, 255, 255, 120 };
+        for (int i = 0; i < historySize && quads < maxQuads; ++i) {
+            float ms = frameTimes[(historyIndex + i) % historySize];
+            float height = ms * msScale < graphHeight ? ms * msScale : graphHeight;
+            addQuad(quads++, 4.0f + i, graphTop + graphHeight - height, 1.0f, height, ms > 16.7f ? red : green);
+        }
+        if (quads < maxQuads)
+            addQuad(quads++, 4.0f, graphTop + graphHeight - 16.7f * msScale, static_cast<float>(historySize), 1.0f, line);
+
+        // Um envio e uma chamada de desenho. glBufferData troca o armazenamento do buffer a cada quadro,
+        // então o driver não precisa esperar a GPU terminar de ler o quadro anterior.
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(quads) * 4 * sizeof(HudVertex), vertices, GL_STREAM_DRAW);
+
+        glDisable(GL_TEXTURE_2D);
+        glPushMatrix();
+        glTranslatef(0.0f, static_cast<float>(windowHeight), 0.0f);
+        glScalef(scale, -scale, 1.0f);  // O stb_easy_font usa y para baixo; a projeção do jogo, y para cima.
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(3, GL_FLOAT, sizeof(HudVertex), reinterpret_cast<const void*>(0));
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(HudVertex), reinterpret_cast<const void*>(3 * sizeof(float)));
+        glDrawArrays(GL_QUADS, 0, quads * 4);
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glPopMatrix();
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glEnable(GL_TEXTURE_2D);
+    }
+
+private:
+    // Formato de vértice do stb_easy_font.
+    struct HudVertex {
+        float x, y, z;
+        unsigned char color[4];
+    };
+
+    static const int historySize = 120;  // Quadros no gráfico.
+    static const int maxQuads = 2048;  // O texto usa cerca de 4 quadriláteros por letra; mais as barras do gráfico.
+    const float scale = 2.0f;  // Tamanho do painel na tela.
+    const float panelWidth = 4.0f + historySize + 4.0f;
+    const float panelHeight = 88.0f;
+
+    // Escreve um retângulo (em coordenadas do painel) na posição index do buffer de vértices.
+    void addQuad(int index, float x, float y, float width, float height, const unsigned char color[4]) {
+        HudVertex* v = vertices + index * 4;
+        const float xs[4] = { x, x + width, x + width, x };
+        const float ys[4] = { y, y, y + height, y + height };
+        for (int i = 0; i < 4; ++i) {
+            v[i].x = xs[i];
+            v[i].y = ys[i];
+            v[i].z = 0.0f;
+            for (int c = 0; c < 4; ++c)
+                v[i].color[c] = color[c];
+        }
+    }
+
+    // Memória residente do processo, em bytes (0 se a plataforma não informar).
+    static double readResidentBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return static_cast<double>(counters.WorkingSetSize);
+        return 0.0;
+#elif defined(__linux__)
+        // /proc/self/statm: tamanho total e residente, em páginas. Lido sem stdio para não alocar.
+        int fd = open("/proc/self/statm", O_RDONLY);
+        if (fd < 0)
+            return 0.0;
+        char buffer[128];
+        ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (length <= 0)
+            return 0.0;
+        buffer[length] = '\0';
+        long long pages = 0;
+        if (sscanf(buffer, "%*s %lld", &pages) != 1)
+            return 0.0;
+        return static_cast<double>(pages) * sysconf(_SC_PAGESIZE);
+#else
+        return 0.0;
+#endif
+    }
+
+    GLuint vbo = 0;
+    HudVertex vertices[maxQuads * 4];
+    float frameTimes[historySize] = {};
+    int historyIndex = 0;
+    int64_t accumulatedNs = 0;
+    int accumulatedFrames = 0;
+    int64_t accumulatedTicks = 0;
+    double fps = 0.0, averageMs = 0.0, ticksPerFrame = 0.0, residentBytes = 0.0;
+    int lastDrawCalls = 0;
+};
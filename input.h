@@ -0,0 +1,110 @@
+#pragma once
+
+#include <GLFW/glfw3.h>  // Callback de teclado.
+#include <atomic>  // Índices da fila sem travas.
+#include <chrono>  // Relógio de alta resolução para os carimbos de tempo.
+#include <cstddef>  // size_t.
+#include <cstdint>  // int64_t.
+#include "profiler.h"  // F12 grava o trace do perfilador.
+
+// Relógio único usado pela entrada e pela simulação, em nanossegundos.
+inline int64_t clockNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Ações do jogador que a simulação entende.
+enum class InputAction : uint8_t {
+    Flap,  // Espaço: o pássaro "bate as asas".
+    Reset,  // R: reinicia o jogo depois de uma colisão.
+};
+
+// Evento de entrada com o instante (clockNowNs) em que foi recebido.
+struct InputEvent {
+    InputAction action;
+    int64_t timeNs;
+};
+
+// Fila circular sem travas para um produtor e um consumidor. Capacity deve ser potência de 2.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity deve ser potência de 2.");
+
+public:
+    // Insere um item; retorna false (descartando-o) se a fila estiver cheia.
+    bool push(const T& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == Capacity)
+            return false;
+        items[tail & (Capacity - 1)] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consulta o próximo item sem removê-lo.
+    bool peek(T& item) const {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire))
+            return false;
+        item = items[head & (Capacity - 1)];
+        return true;
+    }
+
+    // Remove o próximo item.
+    bool pop(T& item) {
+        if (!peek(item))
+            return false;
+        headIndex.store(headIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T items[Capacity];
+    std::atomic<size_t> headIndex{ 0 };
+    std::atomic<size_t> tailIndex{ 0 };
+};
+
+// Entrada orientada a eventos: em vez de consultar glfwGetKey uma vez por quadro, registra cada tecla
+// pressionada (apenas a borda de descida, sem repetição ao segurar) com o instante em que chegou.
+// A simulação consome os eventos no passo fixo correspondente a esse instante, então um toque mais
+// curto que um quadro nunca se perde e o resultado não depende da taxa de quadros.
+class InputQueue {
+public:
+    // Registra o callback de teclado na janela. A janela guarda um ponteiro para esta fila.
+    void attach(GLFWwindow* window) {
+        glfwSetWindowUserPointer(window, this);
+        glfwSetKeyCallback(window, keyCallback);
+    }
+
+    // Próximo evento pendente, sem removê-lo.
+    bool peek(InputEvent& event) const {
+        return events.peek(event);
+    }
+
+    // Remove o próximo evento pendente.
+    bool pop(InputEvent& event) {
+        return events.pop(event);
+    }
+
+    // Insere um evento diretamente (usado pelo callback).
+    void push(InputAction action, int64_t timeNs) {
+        events.push(InputEvent{ action, timeNs });
+    }
+
+private:
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+        (void)scancode;
+        (void)mods;
+        if (action != GLFW_PRESS)
+            return;  // Ignora GLFW_REPEAT e GLFW_RELEASE: segurar a tecla não gera novas batidas.
+
+        InputQueue* queue = static_cast<InputQueue*>(glfwGetWindowUserPointer(window));
+        if (key == GLFW_KEY_SPACE)
+            queue->push(InputAction::Flap, clockNowNs());
+        else if (key == GLFW_KEY_R)
+            queue->push(InputAction::Reset, clockNowNs());
+        else if (key == GLFW_KEY_F12)
+            profilerRequestDump();  // Não é uma ação do jogo: só pede a gravação do trace.
+    }
+
+    SpscQueue<InputEvent, 256> events;
+};
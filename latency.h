@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>  // sort.
+#include <cstdint>  // int64_t.
+#include <iomanip>  // Formatação do relatório.
+#include <iostream>  // Relatório no console.
+#include <vector>  // Amostras coletadas.
+
+// Medição da latência entre a tecla pressionada e a imagem na tela (modo --medir-latencia).
+// Cada batida de asas passa por quatro instantes, todos em clockNowNs():
+//   evento   - callback de teclado (InputEvent::timeNs);
+//   passo    - o passo de simulação que aplicou Bird::flap();
+//   desenho  - o primeiro Bird::draw() que mostrou a nova posição;
+//   swap     - o retorno de glfwSwapBuffers() desse quadro.
+// No fim, report() mostra os percentis de cada etapa e do total.
+class LatencyTracker {
+public:
+    explicit LatencyTracker(bool enabled = false) : enabled(enabled) {
+        if (enabled) {
+            pending.reserve(64);
+            samples.reserve(4096);
+        }
+    }
+
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    // Uma batida de asas foi aplicada pela simulação.
+    void onConsumed(int64_t eventNs, int64_t consumedNs) {
+        if (enabled)
+            pending.push_back(Sample{ eventNs, consumedNs, 0, 0 });
+    }
+
+    // O pássaro acabou de ser desenhado com o estado atual da simulação.
+    void onDrawn(int64_t drawnNs) {
+        if (!enabled)
+            return;
+        for (auto& sample : pending) {
+            if (sample.drawnNs == 0)
+                sample.drawnNs = drawnNs;
+        }
+    }
+
+    // glfwSwapBuffers() retornou: fecha as amostras que já foram desenhadas.
+    void onPresented(int64_t presentedNs) {
+        if (!enabled || pending.empty())
+            return;
+        for (auto& sample : pending) {
+            if (sample.drawnNs != 0) {
+                sample.presentedNs = presentedNs;
+                samples.push_back(sample);
+            }
+        }
+        pending.erase(std::remove_if(pending.begin(), pending.end(), [](const Sample& s) { return s.presentedNs != 0; }), pending.end());
+    }
+
+    // Mostra p50, p90, p99 e máximo de cada etapa, em milissegundos.
+    void report(std::ostream& out) const {
+        if (!enabled)
+            return;
+        out << "Latência entrada -> tela (" << samples.size() << " batidas de asas):" << std::endl;
+        if (samples.empty())
+            return;
+
+        std::vector<double> eventToTick, tickToDraw, drawToSwap, total;
+        for (const auto& s : samples) {
+            eventToTick.push_back((s.consumedNs - s.eventNs) / 1e6);
+            tickToDraw.push_back((s.drawnNs - s.consumedNs) / 1e6);
+            drawToSwap.push_back((s.presentedNs - s.drawnNs) / 1e6);
+            total.push_back((s.presentedNs - s.eventNs) / 1e6);
+        }
+        out << "  etapa              p50      p90      p99      max  (ms)" << std::endl;
+        printStage(out, "evento -> passo  ", eventToTick);
+        printStage(out, "passo -> desenho ", tickToDraw);
+        printStage(out, "desenho -> swap  ", drawToSwap);
+        printStage(out, "total            ", total);
+    }
+
+private:
+    struct Sample {
+        int64_t eventNs, consumedNs, drawnNs, presentedNs;
+    };
+
+    // Percentil pelo método do posto mais próximo; values deve estar ordenado.
+    static double percentile(const std::vector<double>& values, double p) {
+        size_t rank = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+        return values[rank];
+    }
+
+    static void printStage(std::ostream& out, const char* name, std::vector<double>& values) {
+        std::sort(values.begin(), values.end());
+        const std::streamsize precision = out.precision();
+        out << "  " << name << std::fixed << std::setprecision(3)
+            << std::setw(8) << percentile(values, 50) << " " << std::setw(8) << percentile(values, 90) << " "
+            << std::setw(8) << percentile(values, 99) << " " << std::setw(8) << values.back() << std::endl;
+        out.unsetf(std::ios::floatfield);
+        out.precision(precision);
+    }
+
+    bool enabled;
+    std::vector<Sample> pending;  // Batidas aplicadas que ainda não chegaram à tela.
+    std::vector<Sample> samples;  // Batidas completas.
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <condition_variable>  // Espera pela thread no --verificar-alocacoes.
+#include <cstdint>  // uint64_t.
+#include <mutex>  // Fila compartilhada com o World.
+#include <thread>  // Thread de geração.
+#include "alloc_tracker.h"  // Alocações atribuídas à geração.
+#include "game.h"  // World, LevelChunkQueue, LevelGenerator.
+
+// Gera a fase contínua validada em outra thread, alguns blocos à frente do World (até
+// LevelChunkQueue::capacity), para que a simulação do envelope (LevelGenerator) nunca custe um quadro ao
+// laço do jogo. A thread prepara também os primeiros blocos de uma partida recomeçada a partir do estado
+// atual do World, então reiniciar (tecla R) também só copia blocos prontos. Quando a fila não tem o bloco
+// esperado (thread atrasada) o World gera o bloco na hora e a thread recomeça a partir dali, então a fase
+// sai igual com ou sem a thread. Em jogo normal misses() deve ficar em zero (o --verificar-alocacoes confere).
+class LevelPrefetcher {
+public:
+    LevelPrefetcher() : thread(&LevelPrefetcher::generateLoop, this) {}
+
+    ~LevelPrefetcher() {
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.stopping = true;
+        }
+        queue.wake.notify_one();
+        thread.join();
+    }
+
+    LevelPrefetcher(const LevelPrefetcher&) = delete;
+    LevelPrefetcher& operator=(const LevelPrefetcher&) = delete;
+
+    // Passa a abastecer world, a partir do estado atual do gerador dele. O World guarda só o ponteiro: o
+    // LevelPrefetcher deve durar mais que ele (ou world.chunks deve voltar a nullptr antes).
+    void attach(World& world) {
+        queue.restart(world.generator);
+        world.chunks = &queue;
+    }
+
+    // Espera a thread encher a fila e preparar o recomeço, como ela consegue entre dois quadros do jogo. Para o
+    // --verificar-alocacoes, que simula os quadros muito mais rápido que o tempo real.
+    void waitUntilAhead() {
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        ahead.wait(lock, [this] {
+            return queue.stopping || !queue.hasProducer || (queue.hasRestartEntry && queue.count == LevelChunkQueue::capacity);
+        });
+    }
+
+    // Blocos que o World encontrou prontos e blocos que ele teve de gerar na hora.
+    uint64_t hits() const { return queue.hitCount(); }
+    uint64_t misses() const { return queue.missCount(); }
+
+private:
+    void generateLoop() {
+        ALLOCATION_SCOPE("fase");
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        while (true) {
+            queue.wake.wait(lock, [this] {
+                return queue.stopping || (queue.hasProducer && (!queue.hasRestartEntry || queue.count < LevelChunkQueue::capacity));
+            });
+            if (queue.stopping)
+                return;
+
+            // Gera fora da trava; se o World reiniciou o gerador nesse meio tempo, o bloco é descartado.
+            // O recomeço a partir do estado atual do World vem antes dos blocos adiantados: ele muda a cada
+            // bloco que o World consome.
+            const uint64_t epoch = queue.epoch;
+            if (!queue.hasRestartEntry) {
+                LevelGenerator current = queue.current;
+                lock.unlock();
+                LevelChunkQueue::RestartEntry restart;
+                prepareRestart(current, restart);
+                lock.lock();
+                if (queue.epoch == epoch && queue.current.restartCount() == restart.first.restarts &&
+                    queue.current.chunkIndex() == restart.first.index) {
+                    queue.restartEntry = restart;
+                    queue.hasRestartEntry = true;
+                    ahead.notify_all();
+                }
+                continue;
+            }
+
+            LevelGenerator generator = queue.producer;
+            lock.unlock();
+            LevelChunkQueue::Entry entry;
+            generate(generator, entry);
+            lock.lock();
+            if (queue.epoch != epoch)
+                continue;
+            queue.entries[(queue.first + queue.count) % LevelChunkQueue::capacity] = entry;
+            queue.producer = generator;
+            ++queue.count;
+            ahead.notify_all();
+        }
+    }
+
+    // Gera em entry o próximo bloco de generator e o avança.
+    static void generate(LevelGenerator& generator, LevelChunkQueue::Entry& entry) {
+        entry.restarts = generator.restartCount();
+        entry.index = generator.chunkIndex();
+        generator.nextChunk(entry.chunk);
+        entry.after = generator;
+    }
+
+    // Os dois primeiros blocos de uma partida recomeçada a partir de generator, como em World::resetLevel.
+    static void prepareRestart(LevelGenerator generator, LevelChunkQueue::RestartEntry& restart) {
+        restart.first.restarts = generator.restartCount();
+        restart.first.index = generator.chunkIndex();
+        generator.restart(Bird(), World::firstEndlessPipe());
+        generator.nextChunk(restart.first.chunk);
+        restart.first.after = generator;
+        generate(generator, restart.second);
+    }
+
+    LevelChunkQueue queue;
+    std::condition_variable ahead;  // Avisa waitUntilAhead a cada bloco pronto.
+    std::thread thread;  // Depois de queue e ahead: só começa com eles construídos.
+};
@@ -1,189 +1,541 @@
-#include <GL/glew.h>  // Biblioteca para facilitar o uso de extenses do OpenGL.
+#include <GL/glew.h>  // Biblioteca para facilitar o uso de extensões do OpenGL.
 #include <GLFW/glfw3.h>  // Biblioteca para criar janelas, contextos OpenGL e capturar entradas.
-#include <iostream>  // Biblioteca padro C++ para entrada e sada.
-#include <cstdlib>  // Biblioteca para funes utilitrias, como rand().
-#define STB_IMAGE_IMPLEMENTATION  // Define a implementao de stb_image.
+#include <iostream>  // Biblioteca padrão C++ para entrada e saída.
+#include <cstdlib>  // Biblioteca para funções utilitárias, como rand().
+#include <cstring>  // Biblioteca para manipulação de strings C, como strcmp().
+#include <chrono>  // Medição do tempo até o primeiro quadro.
+#include <memory>  // unique_ptr para os subsistemas opcionais.
+#include <random>  // Semente aleatória das partidas.
+#include <thread>  // sleep_for no benchmark de renderização.
+#define ALLOC_TRACKER_IMPLEMENTATION  // Define os operator new/delete rastreados (com RASTREAR_ALOCACOES).
+#include "alloc_tracker.h"  // Contagem de alocações por quadro e por subsistema.
+#include "texture.h"  // Carregamento de texturas (síncrono, assíncrono e comprimido).
+#include "asset_watcher.h"  // Recarregamento de sprites alterados no disco.
+#include "input.h"  // Fila de eventos de teclado com carimbo de tempo.
+#include "latency.h"  // Medição da latência entre a tecla e a tela.
+#include "frame_scheduler.h"  // Agendamento de quadros para baixa latência.
+#include "game.h"  // Pássaro, tubos e estado da partida.
+#include "level_prefetcher.h"  // Geração da fase contínua em outra thread.
+#include "replay.h"  // Gravação e reprodução de partidas.
+#include "profiler.h"  // Zonas do perfilador (opção PERFILADOR).
+#include "gpu_profiler.h"  // Tempos da GPU por etapa de renderização.
+#include "hud.h"  // Painel de desempenho.
+#include "metrics.h"  // Métricas para o monitoramento dos quiosques.
+#include "game_loop.h"  // Entrada, simulação e métricas de cada quadro.
+#include "frame_stats.h"  // Percentis do tempo de quadro e detecção de engasgos.
+#include "render_benchmark.h"  // Benchmark de renderização sem janela visível.
+#ifdef CONTEXTO_EGL
+#include "headless_gl.h"  // Contexto EGL dos modos sem janela (benchmark, verificação) sem servidor gráfico.
+#endif
+#include "startup.h"  // Tempo de cada etapa da inicialização.
+#ifdef EMBUTIR_ASSETS
+#include "embedded_assets.h"  // Sprites decodificados em tempo de build (gerado pelo EmbutirAssets).
+#endif
+#ifdef RASTREAR_ALOCACOES
+// As alocações em C do stb_image passam pelo stb_leakcheck, que guarda arquivo e linha de cada bloco e lista
+// ao sair os que não foram liberados. Ele não é seguro para várias threads (as imagens são decodificadas em
+// paralelo), então as chamadas são serializadas aqui. As macros malloc/free dele são desfeitas logo em
+// seguida para não afetar o resto do programa.
+#define STB_LEAKCHECK_IMPLEMENTATION
+#include "stb_leakcheck.h"
+#undef malloc
+#undef free
+#undef realloc
+std::mutex leakcheckMutex;
+
+void* trackedMalloc(size_t size, const char* file, int line) {
+    AllocationTracker::onAllocate();
+    std::lock_guard<std::mutex> lock(leakcheckMutex);
+    return stb_leakcheck_malloc(size, file, line);
+}
+
+void* trackedRealloc(void* pointer, size_t size, const char* file, int line) {
+    AllocationTracker::onAllocate();
+    std::lock_guard<std::mutex> lock(leakcheckMutex);
+    return stb_leakcheck_realloc(pointer, size, file, line);
+}
+
+void trackedFree(void* pointer) {
+    std::lock_guard<std::mutex> lock(leakcheckMutex);
+    stb_leakcheck_free(pointer);
+}
+
+#define STBI_MALLOC(size) trackedMalloc(size, __FILE__, __LINE__)
+#define STBI_REALLOC(pointer, size) trackedRealloc(pointer, size, __FILE__, __LINE__)
+#define STBI_FREE(pointer) trackedFree(pointer)
+#endif
+#define STB_IMAGE_IMPLEMENTATION  // Define a implementação de stb_image.
 #include "stb_image.h"  // Biblioteca para carregar imagens.
 
 const int window_width = 800;  // Largura da janela.
 const int window_height = 600;  // Altura da janela.
 
-// Funo para inicializar o OpenGL e verificar se GLEW foi carregado corretamente.
+
+// Arquivo de origem da textura do pássaro (observado pelo --recarregar-assets).
+#ifdef EMBUTIR_ASSETS
+const char* const bird_texture_path = embedded::pinto.sourcePath;
+#else
+const char* const bird_texture_path = "C:/Users/Aluno/Source/Repos/FlappyBird/pinto.png";
+#endif
+
+// Pede a textura do pássaro ao carregador.
+TextureHandle loadBirdTexture(AsyncTextureLoader& loader) {
+#ifdef EMBUTIR_ASSETS
+    return loader.loadEmbedded(embedded::pinto);  // Usa os pixels embutidos no executável, sem acesso a disco.
+#else
+    return loader.load(bird_texture_path);  // Carrega a textura em segundo plano (compartilhada entre os pássaros).
+#endif
+}
+
+// Máscara de colisão do pássaro para os modos sem OpenGL (reprodução e --verificar-alocacoes), que não
+// carregam a textura. No jogo e no benchmark de renderização ela vem da mesma decodificação da textura
+// (TextureHandle::collisionMask). Retorna nullptr se a imagem não puder ser lida; o pássaro colide então
+// como um quadrado.
+const CollisionMask* decodeBirdCollisionMask() {
+    static CollisionMask mask;
+#ifdef EMBUTIR_ASSETS
+    mask = CollisionMask::fromRgba(embedded::pinto.pixels, embedded::pinto.width, embedded::pinto.height);
+    return &mask;
+#else
+    int width, height, nrChannels;
+    unsigned char* data = stbi_load(bird_texture_path, &width, &height, &nrChannels, 4);  // Sempre RGBA.
+    if (!data) {
+        std::cerr << "Falha ao carregar a máscara de colisão: " << bird_texture_path << std::endl;
+        return nullptr;
+    }
+    mask = CollisionMask::fromRgba(data, width, height);
+    stbi_image_free(data);
+    return &mask;
+#endif
+}
+
+// --verificar-alocacoes: executa a parte do laço principal que não depende do OpenGL (entrada, simulação,
+// métricas, painel e observador de assets) por muitos quadros, com relógio simulado a 60 Hz e teclas
+// sintéticas. Retorna 1 se a thread principal alocar memória em qualquer quadro depois do aquecimento ou, na
+// fase contínua validada, se algum bloco da fase (inclusive o primeiro de cada partida) for gerado no laço.
+int checkAllocations(uint32_t seed, int frames, const LevelConfig& level) {
+#ifdef RASTREAR_ALOCACOES
+    MetricsRegistry metrics;
+    GameLoop loop(seed, 0, false, false, metrics, level);
+    loop.world.bird.mask = decodeBirdCollisionMask();
+    std::unique_ptr<LevelPrefetcher> prefetcher;
+    if (loop.world.level.endless && loop.world.level.reachable) {
+        prefetcher.reset(new LevelPrefetcher());
+        prefetcher->attach(loop.world);
+    }
+    std::unique_ptr<PerformanceHud> hud(new PerformanceHud());  // Só a parte de CPU (frame), sem init/draw.
+    AssetWatcher assetWatcher;
+    FrameStats frameStats;
+    FrameAllocationCounter allocations(1000);
+
+    const int64_t frameNs = 1000000000LL / 60;
+    for (int frame = 0; frame < frames; ++frame) {
+        if (prefetcher)
+            prefetcher->waitUntilAhead();  // No jogo, a thread tem um quadro inteiro (16 ms) de folga.
+        allocations.beginFrame();
+        int64_t nowNs = frame * frameNs;
+        if (frame % 20 == 0)
+            loop.input.push(InputAction::Flap, nowNs);
+        if (loop.world.gameOver)
+            loop.input.push(InputAction::Reset, nowNs);
+        int ticks = loop.simulate(nowNs);
+        assetWatcher.poll([](const std::string&) {});
+        int64_t frameDurationNs = loop.endFrame(nowNs);
+        hud->frame(frameDurationNs, ticks, 7);
+        frameStats.onFrame(nowNs, frameDurationNs, 0, ticks);
+        allocations.endFrame();
+    }
+
+    allocations.report(std::cout);
+    AllocationTracker::report(std::cout);
+    if (prefetcher) {
+        std::cout << "Blocos da fase: " << prefetcher->hits() << " prontos, " << prefetcher->misses()
+                  << " gerados no laço" << std::endl;
+    }
+    return allocations.framesAllocating() == 0 && (!prefetcher || prefetcher->misses() == 0) ? 0 : 1;
+#else
+    (void)seed;
+    (void)frames;
+    (void)level;
+    std::cerr << "--verificar-alocacoes requer o build com -DRASTREAR_ALOCACOES=ON." << std::endl;
+    return 1;
+#endif
+}
+
+// Função para inicializar o OpenGL e verificar se GLEW foi carregado corretamente.
 void initOpenGL() {
-    glewExperimental = GL_TRUE;  // Configurao experimental do GLEW.
-    if (glewInit() != GLEW_OK) {
+    glewExperimental = GL_TRUE;  // Configuração experimental do GLEW.
+    // Num contexto EGL (benchmark sem servidor gráfico) não há display GLX; as funções do OpenGL são
+    // carregadas mesmo assim, só as extensões GLX ficam de fora.
+    GLenum status = glewInit();
+    if (status != GLEW_OK && status != GLEW_ERROR_NO_GLX_DISPLAY) {
         std::cerr << "Erro ao inicializar o GLEW!" << std::endl;
         exit(EXIT_FAILURE);
     }
 
     glEnable(GL_BLEND);  // Habilita a mistura de cores.
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);  // Define a funo de mistura para suporte a transparncia.
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);  // Define a função de mistura para suporte a transparência.
 }
 
-// Funo de callback para ajustar o tamanho da janela de exibio.
-void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);  // Ajusta o OpenGL para o novo tamanho da janela.
+// Habilita as texturas e define a cor de fundo e o sistema de coordenadas do jogo.
+void initScene() {
+    glEnable(GL_TEXTURE_2D);  // Habilita o uso de texturas.
+    glClearColor(0.5f, 0.7f, 1.0f, 1.0f);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, window_width, 0, window_height, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
 }
 
-// Funo para carregar uma textura de uma imagem no formato .png, .jpg, etc.
-GLuint loadTexture(const char* filePath) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);  // Gera um ID de textura.
-    glBindTexture(GL_TEXTURE_2D, textureID);  // Vincula a textura ao OpenGL.
+// Desenha os tubos e o pássaro. Retorna o número de chamadas de desenho (para o painel).
+int drawWorld(const World& world) {
+    glDisable(GL_TEXTURE_2D);  // Desabilita texturas para desenhar os tubos.
+    int drawCalls = 0;
+    {
+        PROFILE_GPU_ZONE("Pipe::draw");
+        for (int i = 0; i < world.pipeCount; ++i) {
+            world.pipe(i).draw();  // Desenha os tubos.
+            drawCalls += 2;  // Parte inferior e superior.
+        }
+    }
 
-    int width, height, nrChannels;
-    // Carrega a imagem usando stb_image.
-    unsigned char* data = stbi_load(filePath, &width, &height, &nrChannels, 0);
-    if (data) {
-        std::cout << "Imagem carregada: " << filePath << ", Largura: " << width << ", Altura: " << height << ", Canais: " << nrChannels << std::endl;
-        // Define o formato da imagem com base no nmero de canais (1 = preto e branco, 3 = RGB, 4 = RGBA).
-        GLenum format;
-        if (nrChannels == 1)
-            format = GL_RED;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-
-        // Envia a imagem para o OpenGL como textura 2D.
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else {
-        std::cerr << "Failed to load texture: " << filePath << std::endl;
-    }
-    stbi_image_free(data);  // Libera a memria da imagem carregada.
-
-    // Configura parmetros de filtragem e repetio da textura.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    return textureID;  // Retorna o ID da textura carregada.
+    glEnable(GL_TEXTURE_2D);  // Habilita texturas novamente para desenhar o pássaro, depois de desenhar os tubos, se não eles ficam invisíveis por algum motivo (kkkkkkk).
+    {
+        PROFILE_GPU_ZONE("Bird::draw");
+        world.bird.draw();  // Desenha o pássaro.
+        drawCalls += 1;
+    }
+    return drawCalls;
 }
 
-// Estrutura que define o pssaro do jogo.
-struct Bird {
-    float x, y;  // Posio do pssaro.
-    float velocity;  // Velocidade vertical do pssaro.
-    GLuint texture;  // Textura associada ao pssaro.
-    const float gravity = -0.0001f;  // Constante para gravidade.
-    const float flapStrength = 0.1f;  // Fora do "batimento de asas".
+// Função de callback para ajustar o tamanho da janela de exibição.
+void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
+    glViewport(0, 0, width, height);  // Ajusta o OpenGL para o novo tamanho da janela.
+}
 
-    // Construtor que inicializa o pssaro na posio inicial e carrega sua textura.
-    Bird() : x(100.0f), y(300.0f), velocity(0.0f) {
-        texture = loadTexture("C:/Users/Aluno/Source/Repos/FlappyBird/pinto.png");  // Carrega a textura.
-    }
+// Contexto OpenGL sem janela visível, para os modos que não mostram o jogo: o de uma janela invisível do
+// GLFW ou, no build com CONTEXTO_EGL e sem servidor gráfico (DISPLAY e WAYLAND_DISPLAY vazios, como em CI),
+// um contexto EGL sem janela.
+class OffscreenContext {
+public:
+    OffscreenContext() = default;
 
-    // Reinicia o pssaro para a posio inicial.
-    void reset() {
-        x = 100.0f;
-        y = 300.0f;
-        velocity = 0.0f;
+    ~OffscreenContext() {
+        if (window)
+            glfwTerminate();
     }
 
-    // Atualiza a posio do pssaro de acordo com a gravidade e a velocidade.
-    void update() {
-        velocity += gravity;  // Acelera pela gravidade.
-        y += velocity;  // Atualiza a posio vertical.
+    OffscreenContext(const OffscreenContext&) = delete;
+    OffscreenContext& operator=(const OffscreenContext&) = delete;
 
-        // Evita que o pssaro caia abaixo do cho.
-        if (y < 0.0f) {
-            y = 0.0f;
-            velocity = 0.0f;
+    // Cria o contexto, o torna atual e inicializa o GLEW. Retorna false (com a mensagem no cerr) se falhar.
+    bool create(const char* title) {
+#ifdef CONTEXTO_EGL
+        if (!getenv("DISPLAY") && !getenv("WAYLAND_DISPLAY")) {
+            if (!eglContext.create(window_width, window_height)) {
+                std::cerr << "Falha ao criar o contexto EGL sem janela!" << std::endl;
+                return false;
+            }
+            headless = true;
         }
+#endif
+        if (!headless) {
+            if (!glfwInit()) {
+                std::cerr << "Falha ao inicializar o GLFW!" << std::endl;
+                return false;
+            }
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            window = glfwCreateWindow(window_width, window_height, title, nullptr, nullptr);
+            if (!window) {
+                std::cerr << "Falha ao criar a janela GLFW!" << std::endl;
+                glfwTerminate();
+                return false;
+            }
+            glfwMakeContextCurrent(window);
+            glfwSwapInterval(0);
+        }
+        initOpenGL();
+        return true;
     }
 
-    // Aplica a fora de "batimento de asas" ao pssaro.
-    void flap() {
-        velocity = flapStrength;
+    // Plataforma EGL usada, ou vazio com a janela do GLFW.
+    const char* platform() const {
+#ifdef CONTEXTO_EGL
+        if (headless)
+            return eglContext.platform();
+#endif
+        return "";
     }
 
-    // Desenha o pssaro usando OpenGL.
-    void draw() const {
-        glBindTexture(GL_TEXTURE_2D, texture);  // Vincula a textura do pssaro.
-        glColor3f(1.0f, 1.0f, 1.0f);  // Define a cor como branca.
-
-        // Desenha um quadrado na posio do pssaro.
-        glBegin(GL_QUADS);
-        glTexCoord2f(0.0f, 0.0f); glVertex2f(x - 15.0f, y - 15.0f);
-        glTexCoord2f(1.0f, 0.0f); glVertex2f(x + 15.0f, y - 15.0f);
-        glTexCoord2f(1.0f, 1.0f); glVertex2f(x + 15.0f, y + 15.0f);
-        glTexCoord2f(0.0f, 1.0f); glVertex2f(x - 15.0f, y + 15.0f);
-        glEnd();
-    }
+private:
+#ifdef CONTEXTO_EGL
+    HeadlessGlContext eglContext;
+#endif
+    GLFWwindow* window = nullptr;
+    bool headless = false;
 };
 
-// Estrutura que define os tubos (obstculos) do jogo.
-struct Pipe {
-    float x, height;  // Posio e altura do tubo.
-    bool passed;  // Indica se o pssaro j passou pelo tubo.
+// --verificar-texturas: cria 10.000 pássaros que pedem a mesma textura ao carregador e confere que a imagem
+// é decodificada uma única vez, que todos usam o mesmo ID e que a textura é apagada (e sai do cache) só
+// quando o último pássaro deixa de existir. Retorna 1 se alguma condição falhar.
+int checkTextureCache(const char* path) {
+    OffscreenContext context;
+    if (!context.create("Flappy Bird (verificação)"))
+        return -1;
 
-    // Construtor que inicializa o tubo na posio e altura fornecidas.
-    Pipe(float startX, float h) : x(startX), height(h), passed(false) {}
+    int failures = 0;
+    auto expect = [&failures](bool condition, const char* description) {
+        std::cout << (condition ? "  OK      " : "  FALHOU  ") << description << std::endl;
+        failures += condition ? 0 : 1;
+    };
+
+    AsyncTextureLoader loader;
+    {
+        std::vector<Bird> birds(10000);
+        for (Bird& bird : birds)
+            bird.texture = loader.load(path);
+        for (int64_t start = clockNowNs(); loader.pending() > 0 && clockNowNs() - start < 10000000000LL;) {
+            loader.update();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
 
-    // Reinicia o tubo na posio e altura fornecidas.
-    void reset(float startX, float h) {
-        x = startX;
-        height = h;
-        passed = false;
+        const GLuint texture = birds[0].texture.get();
+        bool shared = true;
+        for (const Bird& bird : birds)
+            shared = shared && bird.texture.ready() && bird.texture.get() == texture;
+        std::cout << "Textura " << path << ", " << birds.size() << " pássaros:" << std::endl;
+        expect(birds[0].texture.ready() && !birds[0].texture.failed(), "textura carregada");
+        expect(loader.decodeCount() == 1, "uma única decodificação");
+        expect(loader.cachedCount() == 1, "uma única entrada no cache");
+        expect(shared, "o mesmo ID em todos os pássaros");
+        expect(isCompressedTexturePath(path) || birds[0].texture.collisionMask(), "máscara de colisão da mesma decodificação");
+
+        birds.resize(1);
+        loader.update();
+        expect(glIsTexture(texture) && loader.cachedCount() == 1, "textura mantida enquanto resta um pássaro");
+
+        birds.clear();
+        loader.update();
+        expect(!glIsTexture(texture) && loader.cachedCount() == 0, "textura apagada depois do último pássaro");
     }
+    loader.release();
+    return failures == 0 ? 0 : 1;
+}
 
-    // Atualiza a posio do tubo (movendo-se da direita para a esquerda).
-    void update(float speed) {
-        x -= speed;  // Move o tubo para a esquerda.
+// --benchmark-render: joga uma partida roteirizada (semente fixa, batida de asas a cada 20 quadros, relógio
+// simulado a 60 Hz) por frames quadros, desenhando em um framebuffer fora da tela, e mede os tempos de CPU,
+// GPU e total de cada quadro, num OffscreenContext.
+// Com baselinePath, retorna 1 se o p95 do tempo total piorou mais que tolerancePct por cento em relação à
+// linha de base.
+int renderBenchmark(uint32_t seed, int frames, const char* baselinePath, const char* saveBaselinePath, double tolerancePct) {
+    OffscreenContext context;
+    if (!context.create("Flappy Bird (benchmark)"))
+        return -1;
 
-        // Se o tubo sair da tela, reinicializa-o em uma nova posio com nova altura.
-        if (x < -50.0f) {
-            x = 800.0f;
-            height = static_cast<float>(rand() % 300 + 100);  // Altura aleatria.
-            passed = false;
+    // Desenha em um framebuffer próprio: o resultado não depende do compositor nem do tamanho da janela.
+    GLuint framebuffer = 0, colorBuffer = 0;
+    if (GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object) {
+        glGenRenderbuffers(1, &colorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, window_width, window_height);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);  // Usa o buffer da janela invisível (ou o pbuffer do EGL).
+    }
+    glViewport(0, 0, window_width, window_height);
+    initScene();
+
+    const bool timerQueries = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    GLuint query = 0;
+    if (timerQueries)
+        glGenQueries(1, &query);
+    const char* rendererName = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    const std::string renderer = rendererName ? rendererName : "desconhecido";
+
+    // Espera a textura do pássaro (e a máscara de colisão, que vem com ela), para que todos os quadros
+    // medidos desenhem a mesma cena do jogo.
+    AsyncTextureLoader textureLoader;
+    MetricsRegistry metrics;
+    GameLoop loop(seed, 0, false, false, metrics);
+    loop.world.bird.texture = loadBirdTexture(textureLoader);
+    for (int64_t start = clockNowNs(); !loop.world.bird.texture.ready() && clockNowNs() - start < 5000000000LL;) {
+        textureLoader.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    loop.world.bird.mask = loop.world.bird.texture.collisionMask();
+
+    const int warmupFrames = 60;  // Compilação de shaders do driver, caches, etc.
+    const int64_t frameStepNs = 1000000000LL / 60;
+    RenderBenchmark benchmark;
+    for (int frame = 0; frame < warmupFrames + frames; ++frame) {
+        int64_t gameNs = frame * frameStepNs;
+        if (frame % 20 == 0)
+            loop.input.push(InputAction::Flap, gameNs);
+        if (loop.world.gameOver)
+            loop.input.push(InputAction::Reset, gameNs);
+
+        int64_t startNs = clockNowNs();
+        if (timerQueries)
+            glBeginQuery(GL_TIME_ELAPSED, query);
+        glClear(GL_COLOR_BUFFER_BIT);
+        loop.simulate(gameNs);
+        textureLoader.update();
+        drawWorld(loop.world);
+        if (timerQueries)
+            glEndQuery(GL_TIME_ELAPSED);
+        int64_t submittedNs = clockNowNs();
+        glFinish();
+        int64_t endNs = clockNowNs();
+
+        int64_t gpuNs = -1;
+        if (timerQueries) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            gpuNs = static_cast<int64_t>(elapsed);
         }
+        loop.endFrame(gameNs);
+        if (frame >= warmupFrames)
+            benchmark.onFrame(submittedNs - startNs, gpuNs, endNs - startNs);
     }
 
-    // Desenha o tubo usando OpenGL.
-    void draw() const {
-        glColor3f(0.0f, 1.0f, 0.0f);  // Define a cor do tubo como verde.
-
-        // Desenha a parte inferior do tubo.
-        glBegin(GL_QUADS);
-        glVertex2f(x - 25.0f, 0.0f);
-        glVertex2f(x + 25.0f, 0.0f);
-        glVertex2f(x + 25.0f, height);
-        glVertex2f(x - 25.0f, height);
-        glEnd();
+    std::cout << "Benchmark de renderização: " << frames << " quadros, semente " << seed << ", " << renderer;
+    if (context.platform()[0])
+        std::cout << " (" << context.platform() << ")";
+    std::cout << std::endl;
+    benchmark.report(std::cout);
+
+    int result = 0;
+    if (saveBaselinePath) {
+        if (benchmark.baseline(seed, renderer).save(saveBaselinePath))
+            std::cout << "Linha de base gravada em " << saveBaselinePath << std::endl;
+        else
+            result = -1;
+    }
+    if (baselinePath) {
+        RenderBaseline reference;
+        result = reference.load(baselinePath) ? benchmark.check(reference, renderer, tolerancePct, std::cout) : -1;
+    }
 
-        // Desenha a parte superior do tubo.
-        glBegin(GL_QUADS);
-        glVertex2f(x - 25.0f, 600.0f);
-        glVertex2f(x + 25.0f, 600.0f);
-        glVertex2f(x + 25.0f, height + 200.0f);
-        glVertex2f(x - 25.0f, height + 200.0f);
-        glEnd();
+    if (timerQueries)
+        glDeleteQueries(1, &query);
+    if (framebuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
     }
+    textureLoader.release();
+    return result;
+}
 
-    // Verifica se o pssaro colidiu com o tubo.
-    bool isColliding(const Bird& bird) const {
-        return (bird.x + 15.0f > x - 25.0f && bird.x - 15.0f < x + 25.0f &&
-            (bird.y - 15.0f < height || bird.y + 15.0f > height + 200.0f));
+// Função principal do programa.
+int main(int argc, char** argv) {
+    auto startTime = std::chrono::steady_clock::now();  // Início da contagem do tempo até o primeiro quadro.
+    StartupTimeline startup(clockNowNs());
+
+    // Opções de linha de comando.
+    bool hotReload = false;  // --recarregar-assets: recarrega os sprites alterados no disco sem reiniciar o jogo.
+    bool measureLatency = false;  // --medir-latencia: mede o tempo entre a tecla e a tela e mostra os percentis ao sair.
+    bool lowLatency = false;  // --baixa-latencia: vsync com o quadro começando no último momento seguro antes do vblank.
+    bool showHud = false;  // --hud: mostra FPS, gráfico do tempo de quadro, passos por quadro, desenhos e memória.
+    std::string metricsFile;  // --metricas-arquivo <arquivo>: grava as métricas (formato do Prometheus) a cada 10 s.
+    std::string metricsSocket;  // --metricas-socket <caminho>: serve as métricas em um socket Unix local.
+    const char* recordPath = nullptr;  // --gravar <arquivo>: grava a semente e as ações da partida ao sair.
+    const char* replayPath = nullptr;  // --reproduzir <arquivo>: reproduz uma partida gravada, sem janela, e confere o resultado.
+    int allocationCheckFrames = 0;  // --verificar-alocacoes [quadros]: confere, sem janela, que o laço não aloca memória.
+    const char* textureCheckPath = nullptr;  // --verificar-texturas [arquivo]: confere o cache de texturas com 10.000 pássaros.
+    bool reportStartup = false;  // --tempo-inicializacao: mostra a duração de cada etapa até o primeiro quadro.
+    bool exitAfterFirstFrame = false;  // --sair-no-primeiro-quadro: fecha depois do primeiro quadro completo (benchmark).
+    int renderBenchmarkFrames = 0;  // --benchmark-render [quadros]: mede a renderização de uma partida roteirizada.
+    const char* baselinePath = nullptr;  // --linha-de-base <arquivo>: compara o benchmark de renderização com este resultado.
+    const char* saveBaselinePath = nullptr;  // --gravar-linha-de-base <arquivo>: grava o resultado do benchmark.
+    double tolerancePct = 10.0;  // --tolerancia <pct>: piora aceitável do p95 em relação à linha de base.
+    bool seedGiven = false;
+    uint32_t seed = std::random_device()();  // --semente <n>: fixa a sequência de alturas dos tubos.
+    LevelConfig level;  // --fase-continua, --espacamento <mín> <máx>, --variacao-altura <px>: fase gerada à frente.
+                        // --fase-sem-validacao: aceita tubos impossíveis de alcançar a partir do anterior.
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--recarregar-assets") == 0)
+            hotReload = true;
+        else if (strcmp(argv[i], "--medir-latencia") == 0)
+            measureLatency = true;
+        else if (strcmp(argv[i], "--baixa-latencia") == 0)
+            lowLatency = true;
+        else if (strcmp(argv[i], "--hud") == 0)
+            showHud = true;
+        else if (strcmp(argv[i], "--metricas-arquivo") == 0 && i + 1 < argc)
+            metricsFile = argv[++i];
+        else if (strcmp(argv[i], "--metricas-socket") == 0 && i + 1 < argc)
+            metricsSocket = argv[++i];
+        else if (strcmp(argv[i], "--gravar") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--reproduzir") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--verificar-alocacoes") == 0)
+            allocationCheckFrames = i + 1 < argc && argv[i + 1][0] != '-' ? atoi(argv[++i]) : 100000;
+        else if (strcmp(argv[i], "--verificar-texturas") == 0)
+            textureCheckPath = i + 1 < argc && argv[i + 1][0] != '-' ? argv[++i] : bird_texture_path;
+        else if (strcmp(argv[i], "--tempo-inicializacao") == 0)
+            reportStartup = true;
+        else if (strcmp(argv[i], "--sair-no-primeiro-quadro") == 0)
+            exitAfterFirstFrame = true;
+        else if (strcmp(argv[i], "--benchmark-render") == 0)
+            renderBenchmarkFrames = i + 1 < argc && argv[i + 1][0] != '-' ? atoi(argv[++i]) : 2000;
+        else if (strcmp(argv[i], "--linha-de-base") == 0 && i + 1 < argc)
+            baselinePath = argv[++i];
+        else if (strcmp(argv[i], "--gravar-linha-de-base") == 0 && i + 1 < argc)
+            saveBaselinePath = argv[++i];
+        else if (strcmp(argv[i], "--tolerancia") == 0 && i + 1 < argc)
+            tolerancePct = atof(argv[++i]);
+        else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            seedGiven = true;
+        }
+        else if (strcmp(argv[i], "--fase-continua") == 0)
+            level.endless = true;
+        else if (strcmp(argv[i], "--espacamento") == 0 && i + 2 < argc) {
+            level.endless = true;
+            level.minSpacing = static_cast<float>(atof(argv[++i]));
+            level.maxSpacing = static_cast<float>(atof(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--variacao-altura") == 0 && i + 1 < argc) {
+            level.endless = true;
+            level.maxStep = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fase-sem-validacao") == 0) {
+            level.endless = true;
+            level.reachable = false;
+        }
+        else
+            std::cerr << "Opção desconhecida: " << argv[i] << std::endl;
     }
-};
 
-// Funo que reinicia o jogo, resetando o pssaro e os tubos.
-void resetGame(Bird& bird, Pipe pipes[]) {
-    bird.reset();
-    pipes[0].reset(400.0f, 300.0f);
-    pipes[1].reset(650.0f, 250.0f);
-    pipes[2].reset(900.0f, 350.0f);
-}
+    // A reprodução não abre janela: só roda a simulação e compara o estado final.
+    if (replayPath) {
+        Replay replay;
+        if (!replay.load(replayPath))
+            return -1;
+        return playReplay(replay, decodeBirdCollisionMask(), std::cout);
+    }
+    if (allocationCheckFrames > 0) {
+        return checkAllocations(seed, allocationCheckFrames, level);
+    }
+    if (textureCheckPath) {
+        return checkTextureCache(textureCheckPath);
+    }
+    if (renderBenchmarkFrames > 0) {
+        // Sem --semente, usa sempre a mesma partida, para que os resultados sejam comparáveis.
+        return renderBenchmark(seedGiven ? seed : 1, renderBenchmarkFrames, baselinePath, saveBaselinePath, tolerancePct);
+    }
 
-// Funo principal do programa.
-int main() {
+    startup.mark("opcoes");
     if (!glfwInit()) {
         std::cerr << "Falha ao inicializar o GLFW!" << std::endl;
         return -1;
     }
+    startup.mark("glfwInit");
 
     // Cria uma janela e contexto OpenGL.
     GLFWwindow* window = glfwCreateWindow(window_width, window_height, "Flappy Bird Luiz Eduardo", nullptr, nullptr);
@@ -192,64 +544,221 @@ int main() {
         glfwTerminate();
         return -1;
     }
+    startup.mark("glfwCreateWindow");
 
     glfwMakeContextCurrent(window);  // Define o contexto OpenGL da janela.
-    initOpenGL();  // Inicializa o OpenGL e configuraes de renderizao.
-    glEnable(GL_TEXTURE_2D);  // Habilita o uso de texturas.
+    initOpenGL();  // Inicializa o OpenGL e configurações de renderização.
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);  // Configura callback para redimensionamento.
+    initScene();
+    startup.mark("initOpenGL");
 
-    // Define a cor de fundo e o sistema de coordenadas.
-    glClearColor(0.5f, 0.7f, 1.0f, 1.0f);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(0, window_width, 0, window_height, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    // Carregador de texturas em segundo plano: o primeiro quadro não espera a decodificação das imagens.
+    AsyncTextureLoader textureLoader;
 
-    // Inicializa o pssaro e os tubos.
-    Bird bird;
-    Pipe pipes[] = { Pipe(400.0f, 300.0f), Pipe(650.0f, 250.0f), Pipe(900.0f, 350.0f) };
-    bool gameOver = false;
+    // Observa os arquivos dos sprites apenas quando pedido, para não manter uma thread extra nos quiosques.
+    std::unique_ptr<AssetWatcher> assetWatcher;
+    if (hotReload) {
+        assetWatcher.reset(new AssetWatcher());
+        assetWatcher->watch(bird_texture_path);
+    }
+
+    // Métricas: o laço só atualiza valores atômicos; a exportação roda em outra thread.
+    MetricsRegistry metrics;
+    std::unique_ptr<MetricsExporter> metricsExporter;
+    if (!metricsFile.empty() || !metricsSocket.empty()) {
+        metricsExporter.reset(new MetricsExporter(metrics, metricsFile, metricsSocket));
+    }
+
+    // Inicializa o pássaro e os tubos. As teclas chegam por callback, com carimbo de tempo, e são aplicadas
+    // no passo de simulação correspondente.
+    GameLoop loop(seed, clockNowNs(), recordPath != nullptr, measureLatency, metrics, level);
+    World& world = loop.world;
+    LatencyTracker& latency = loop.latency;
+    std::unique_ptr<LevelPrefetcher> prefetcher;  // A validação da fase contínua fica fora do laço.
+    if (world.level.endless && world.level.reachable) {
+        prefetcher.reset(new LevelPrefetcher());
+        prefetcher->attach(world);
+    }
+    world.bird.texture = loadBirdTexture(textureLoader);
+    loop.input.attach(window);
+    startup.mark("texturas_e_jogo");  // Carregador, observador, métricas e estado inicial; a textura chega depois.
+    // A máscara de colisão sai da mesma decodificação da textura: a partida fica parada no passo 0 até ela
+    // chegar, para que a colisão seja a mesma desde o primeiro passo (e igual na reprodução).
+    bool simulationStarted = false;
+    bool firstFrameReported = false;  // Indica se o tempo até o primeiro quadro completo já foi exibido.
+    bool firstSwapDone = false;
+    int exitCode = 0;
+
+    // No modo de baixa latência o quadro dorme até pouco antes do vblank e só então lê a entrada.
+    std::unique_ptr<FrameScheduler> scheduler;
+    if (lowLatency) {
+        glfwSwapInterval(1);
+        const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        scheduler.reset(new FrameScheduler(mode ? mode->refreshRate : 60));
+    }
+
+    // O painel guarda os vértices de um quadro inteiro; só existe quando pedido.
+    std::unique_ptr<PerformanceHud> hud;
+    if (showHud) {
+        hud.reset(new PerformanceHud());
+        hud->init();
+    }
+
+    FrameStats frameStats;  // Histogramas do tempo de quadro e de passo, relatados ao sair.
+
+#ifdef RASTREAR_ALOCACOES
+    FrameAllocationCounter allocations(120);  // Alocações por quadro na thread principal.
+#endif
+
+#ifdef PERFILADOR
+    PROFILE_THREAD("principal");
+    Profiler::instance().installSignalHandler();
+    GpuProfiler::instance().init();
+#endif
+    startup.mark("subsistemas");
 
     // Loop principal do jogo.
     while (!glfwWindowShouldClose(window)) {
-        glClear(GL_COLOR_BUFFER_BIT);  
-
-        // Se o jogo no terminou, atualiza o estado do pssaro e tubos.
-        if (!gameOver) {
-            bird.update();  // Atualiza o pssaro.
-            for (auto& pipe : pipes) {
-                pipe.update(0.05f);  // Move os tubos.
-                if (pipe.isColliding(bird)) {
-                    gameOver = true;  // Verifica coliso com os tubos.
-                }
+#ifdef RASTREAR_ALOCACOES
+        allocations.beginFrame();
+#endif
+        int64_t frameStartNs = 0;
+        if (scheduler) {
+            {
+                PROFILE_ZONE("esperar vblank");
+                frameStartNs = scheduler->waitForFrameStart();
             }
+            PROFILE_ZONE("glfwPollEvents");
+            glfwPollEvents();  // Lê a entrada imediatamente antes de simular.
+        }
+        PROFILE_ZONE("quadro");
+#ifdef PERFILADOR
+        GpuProfiler::instance().beginFrame();
+#endif
+
+        {
+            PROFILE_GPU_ZONE("glClear");
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
 
-            // Se a tecla de espao for pressionada, o pssaro "bate as asas".
-            if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-                bird.flap();
-            }
+        // Aplica as teclas e avança a simulação até o instante atual.
+        int64_t simulationStartNs = clockNowNs();
+        int ticks = simulationStarted ? loop.simulate(simulationStartNs) : 0;
+        int64_t simulationNs = clockNowNs() - simulationStartNs;
+
+        // Pede a nova decodificação dos sprites alterados no disco; o envio acontece em textureLoader.update().
+        if (assetWatcher) {
+            ALLOCATION_SCOPE("assets");
+            assetWatcher->poll([&](const std::string& path) { textureLoader.reloadFile(path); });
         }
-        else {
-            // Se o jogo terminou, permite reiniciar pressionando a tecla "R".
-            if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-                resetGame(bird, pipes);
-                gameOver = false;
-            }
+        textureLoader.update();  // Envia ao OpenGL as texturas que terminaram de ser decodificadas.
+        if (!simulationStarted && (world.bird.texture.ready() || world.bird.texture.failed())) {
+            world.bird.mask = world.bird.texture.collisionMask();  // nullptr se a imagem falhou: colide como quadrado.
+            loop.startClock(clockNowNs());  // O primeiro passo roda no próximo quadro.
+            simulationStarted = true;
+            startup.mark("mascara_de_colisao");
         }
 
-        glDisable(GL_TEXTURE_2D);  // Desabilita texturas para desenhar os tubos.
-        for (const auto& pipe : pipes) {
-            pipe.draw();  // Desenha os tubos.
+        int drawCalls = drawWorld(world);  // Para o painel.
+        latency.onDrawn(clockNowNs());
+
+        int64_t frameEndNs = clockNowNs();
+        int64_t frameNs = loop.endFrame(frameEndNs);
+        frameStats.onFrame(frameEndNs, frameNs, simulationNs, ticks);
+        if (hud) {
+            PROFILE_GPU_ZONE("PerformanceHud::draw");
+            ALLOCATION_SCOPE("hud");
+            hud->frame(frameNs, ticks, drawCalls);
+            hud->draw(window_height);
         }
 
-        glEnable(GL_TEXTURE_2D);  // Habilita texturas novamente para desenhar o pssaro, depois de desenhar os tubos, se no eles ficam invisveis por algum motivo (kkkkkkk).
-        bird.draw();  // Desenha o pssaro.
+        if (scheduler) {
+            // Espera o fim da renderização (para medir o custo real do quadro) e, depois da troca, o vblank.
+            {
+                PROFILE_ZONE("glFinish");
+                glFinish();
+            }
+            int64_t renderDoneNs = clockNowNs();
+            PROFILE_ZONE("glfwSwapBuffers");
+            glfwSwapBuffers(window);
+            glFinish();
+            scheduler->onFramePresented(frameStartNs, renderDoneNs, clockNowNs());
+        }
+        else {
+            PROFILE_ZONE("glfwSwapBuffers");
+            glfwSwapBuffers(window);  // Troca os buffers de exibição.
+        }
+        latency.onPresented(clockNowNs());
+        if (!firstSwapDone) {
+            startup.mark("primeiro_glfwSwapBuffers");  // Primeiro quadro na tela, talvez ainda sem a textura.
+            firstSwapDone = true;
+        }
 
-        glfwSwapBuffers(window);  // Troca os buffers de exibio.
-        glfwPollEvents();  // Verifica eventos como teclas pressionadas.
+        // Mostra uma única vez quanto tempo levou até o primeiro quadro com a textura real do pássaro.
+        if (!firstFrameReported && world.bird.texture.ready()) {
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+            startup.mark("primeiro_quadro_completo");
+            if (reportStartup)
+                startup.report(std::cout);
+            std::cout << "Primeiro quadro completo em " << elapsed.count() << " ms" << std::endl;
+            firstFrameReported = true;
+            if (exitAfterFirstFrame)
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+        else if (!firstFrameReported && exitAfterFirstFrame &&
+                 (world.bird.texture.failed() || std::chrono::steady_clock::now() - startTime > std::chrono::seconds(10))) {
+            // Sem a textura o primeiro quadro completo nunca chega: o benchmark não pode ficar esperando.
+            std::cerr << (world.bird.texture.failed() ? "Falha ao carregar a textura do pássaro"
+                                                      : "A textura do pássaro não chegou em 10 s")
+                      << "; encerrando sem o primeiro quadro completo." << std::endl;
+            firstFrameReported = true;
+            exitCode = 1;
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+        if (!scheduler) {
+            PROFILE_ZONE("glfwPollEvents");
+            glfwPollEvents();  // Processa eventos; as teclas pressionadas entram na fila de entrada.
+        }
+#ifdef RASTREAR_ALOCACOES
+        allocations.endFrame();
+#endif
+#ifdef PERFILADOR
+        // F12 ou SIGUSR1: grava os últimos segundos de zonas para abrir no chrome://tracing ou no Perfetto.
+        if (Profiler::instance().takeDumpRequest()) {
+            if (Profiler::instance().dump("perfil.json", 10.0))
+                std::cout << "Perfil dos últimos 10 s gravado em perfil.json" << std::endl;
+            else
+                std::cerr << "Falha ao gravar perfil.json" << std::endl;
+        }
+#endif
     }
 
+    if (recordPath) {
+        const Replay& recording = loop.finishRecording();
+        if (recording.save(recordPath))
+            std::cout << "Partida gravada em " << recordPath << " (semente " << seed << ", " << recording.ticks << " passos)." << std::endl;
+    }
+    latency.report(std::cout);
+    frameStats.report(std::cout);
+    if (prefetcher) {
+        std::cout << "Blocos da fase: " << prefetcher->hits() << " prontos, " << prefetcher->misses()
+                  << " gerados no laço" << std::endl;
+    }
+    if (scheduler) {
+        scheduler->report(std::cout);
+    }
+#ifdef PERFILADOR
+    GpuProfiler::instance().release();
+#endif
+    if (hud) {
+        hud->release();
+    }
+    textureLoader.release();  // Libera os recursos do carregador enquanto o contexto ainda existe.
     glfwTerminate();  // Finaliza o GLFW.
-    return 0;
+#ifdef RASTREAR_ALOCACOES
+    allocations.report(std::cout);
+    AllocationTracker::report(std::cout);
+    stb_leakcheck_dumpmem();  // Blocos do stb_image que não foram liberados.
+#endif
+    return exitCode;
 }
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <atomic>  // Valores atualizados sem travas.
+#include <chrono>  // Tempo de atividade e intervalo de exportação.
+#include <condition_variable>  // Acorda a thread de exportação para encerrar.
+#include <cstdint>  // uint64_t.
+#include <cstdio>  // rename, remove.
+#include <cstring>  // memcpy.
+#include <ctime>  // Horário de início (time).
+#include <fstream>  // Arquivo de métricas.
+#include <initializer_list>  // Limites dos histogramas.
+#include <iostream>  // Mensagens de erro.
+#include <memory>  // unique_ptr das métricas registradas.
+#include <mutex>  // Registro e encerramento (nunca usados pelo laço de renderização).
+#include <sstream>  // Texto da exposição.
+#include <string>  // Nomes e caminhos.
+#include <thread>  // Thread de exportação.
+#include <vector>  // Métricas registradas.
+#include "alloc_tracker.h"  // Alocações atribuídas à exportação.
+#ifdef __linux__
+#include <sys/socket.h>  // Socket Unix.
+#include <sys/un.h>  // sockaddr_un.
+#include <poll.h>  // Espera por conexões com tempo limite.
+#include <unistd.h>  // read, write, close, unlink.
+#endif
+
+// Métricas para o monitoramento dos quiosques: contadores, medidores e histogramas de limites fixos.
+// O laço do jogo só faz operações atômicas relaxadas; o texto no formato de exposição do Prometheus é
+// montado por uma thread separada (MetricsExporter), que grava um arquivo periodicamente e/ou atende
+// um socket Unix local.
+// Nomes e descrições das métricas devem ser ASCII: este arquivo é Latin-1 e o Prometheus espera UTF-8.
+
+// Guarda um double em um atômico de 64 bits (std::atomic<double> não tem fetch_add antes do C++20).
+inline uint64_t metricBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double metricValue(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Valor que só cresce (ex.: partidas jogadas).
+class MetricCounter {
+public:
+    void add(uint64_t amount = 1) {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value{ 0 };
+};
+
+// Valor que sobe e desce (ex.: tubos na tela).
+class MetricGauge {
+public:
+    void set(double value) {
+        bits.store(metricBits(value), std::memory_order_relaxed);
+    }
+
+    double get() const {
+        return metricValue(bits.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::atomic<uint64_t> bits{ 0 };
+};
+
+// Histograma com limites fixos, escolhidos no registro. observe() é O(número de limites), sem travas.
+class MetricHistogram {
+public:
+    explicit MetricHistogram(std::initializer_list<double> upperBounds)
+        : bounds(upperBounds), counts(new std::atomic<uint64_t>[upperBounds.size() + 1]) {
+        for (size_t i = 0; i <= bounds.size(); ++i)
+            counts[i].store(0, std::memory_order_relaxed);
+    }
+
+    void observe(double value) {
+        size_t bucket = 0;
+        while (bucket < bounds.size() && value > bounds[bucket])
+            ++bucket;
+        counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t expected = sumBits.load(std::memory_order_relaxed);
+        while (!sumBits.compare_exchange_weak(expected, metricBits(metricValue(expected) + value), std::memory_order_relaxed)) {}
+    }
+
+    // Escreve os baldes cumulativos, a soma e a contagem no formato do Prometheus.
+    void write(std::ostream& out, const std::string& name) const {
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            cumulative += counts[i].load(std::memory_order_relaxed);
+            out << name << "_bucket{le=\"" << bounds[i] << "\"} " << cumulative << "\n";
+        }
+        cumulative += counts[bounds.size()].load(std::memory_order_relaxed);
+        out << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+        out << name << "_sum " << metricValue(sumBits.load(std::memory_order_relaxed)) << "\n";
+        out << name << "_count " << cumulative << "\n";
+    }
+
+private:
+    const std::vector<double> bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;  // Um por limite, mais o +Inf.
+    std::atomic<uint64_t> sumBits{ 0 };
+};
+
+// Conjunto de métricas do processo. O registro acontece na inicialização; depois disso o jogo guarda
+// as referências devolvidas e só as atualiza.
+class MetricsRegistry {
+public:
+    MetricsRegistry() : startTime(std::chrono::steady_clock::now()), startUnixSeconds(static_cast<double>(time(nullptr))) {}
+
+    MetricCounter& counter(const char* name, const char* help) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.emplace_back(Entry{ name, help, std::unique_ptr<MetricCounter>(new MetricCounter()), nullptr, nullptr });
+        return *entries.back().counter;
+    }
+
+    MetricGauge& gauge(const char* name, const char* help) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.emplace_back(Entry{ name, help, nullptr, std::unique_ptr<MetricGauge>(new MetricGauge()), nullptr });
+        return *entries.back().gauge;
+    }
+
+    MetricHistogram& histogram(const char* name, const char* help, std::initializer_list<double> upperBounds) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.emplace_back(Entry{ name, help, nullptr, nullptr, std::unique_ptr<MetricHistogram>(new MetricHistogram(upperBounds)) });
+        return *entries.back().histogram;
+    }
+
+    // Texto no formato de exposição do Prometheus (versão 0.0.4). Inclui o tempo de atividade do processo,
+    // que só pode crescer enquanto o jogo não travar nem reiniciar.
+    std::string exposition() const {
+        std::ostringstream out;
+        out.precision(12);
+        std::chrono::duration<double> uptime = std::chrono::steady_clock::now() - startTime;
+        out << "# HELP flappy_uptime_seconds Tempo desde o inicio do processo (zera quando o jogo trava ou reinicia).\n"
+            << "# TYPE flappy_uptime_seconds gauge\n"
+            << "flappy_uptime_seconds " << uptime.count() << "\n";
+        out << "# HELP flappy_start_time_seconds Horario de inicio do processo (Unix).\n"
+            << "# TYPE flappy_start_time_seconds gauge\n"
+            << "flappy_start_time_seconds " << static_cast<uint64_t>(startUnixSeconds) << "\n";
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& entry : entries) {
+            const char* type = entry.counter ? "counter" : entry.gauge ? "gauge" : "histogram";
+            out << "# HELP " << entry.name << " " << entry.help << "\n";
+            out << "# TYPE " << entry.name << " " << type << "\n";
+            if (entry.counter)
+                out << entry.name << " " << entry.counter->get() << "\n";
+            else if (entry.gauge)
+                out << entry.name << " " << entry.gauge->get() << "\n";
+            else
+                entry.histogram->write(out, entry.name);
+        }
+        return out.str();
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    const std::chrono::steady_clock::time_point startTime;
+    const double startUnixSeconds;
+};
+
+// Exporta as métricas em uma thread própria: grava filePath a cada intervalo (em um arquivo temporário
+// renomeado por cima, para que o coletor nunca leia um arquivo pela metade) e, no Linux, responde no
+// socket Unix socketPath a cada conexão (ex.: curl --unix-socket <caminho> http://localhost/metrics).
+// Caminhos vazios desativam a saída correspondente.
+class MetricsExporter {
+public:
+    MetricsExporter(const MetricsRegistry& registry, const std::string& filePath, const std::string& socketPath, int intervalSeconds = 10)
+        : registry(registry), filePath(filePath), socketPath(socketPath), interval(intervalSeconds) {
+#ifdef __linux__
+        if (!socketPath.empty())
+            listenFd = openSocket(socketPath);
+#else
+        if (!socketPath.empty())
+            std::cerr << "Socket de métricas disponível apenas no Linux." << std::endl;
+#endif
+        thread = std::thread(&MetricsExporter::exportLoop, this);
+    }
+
+    ~MetricsExporter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+        writeFile();  // Última leitura, com o processo encerrando normalmente.
+#ifdef __linux__
+        if (listenFd >= 0) {
+            close(listenFd);
+            unlink(socketPath.c_str());
+        }
+#endif
+    }
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+private:
+    void exportLoop() {
+        ALLOCATION_SCOPE("metricas");
+        auto nextWrite = std::chrono::steady_clock::now();
+        while (true) {
+            if (!filePath.empty() && std::chrono::steady_clock::now() >= nextWrite) {
+                writeFile();
+                nextWrite += interval;
+            }
+#ifdef __linux__
+            if (listenFd >= 0) {
+                // Espera conexões em intervalos curtos para perceber o pedido de encerramento.
+                pollfd fd = { listenFd, POLLIN, 0 };
+                if (::poll(&fd, 1, 100) > 0)
+                    serveConnection();
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping)
+                    return;
+                continue;
+            }
+#endif
+            std::unique_lock<std::mutex> lock(mutex);
+            if (wake.wait_until(lock, nextWrite, [this] { return stopping; }))
+                return;
+        }
+    }
+
+    void writeFile() {
+        if (filePath.empty())
+            return;
+        std::string temporary = filePath + ".tmp";
+        {
+            std::ofstream out(temporary);
+            out << registry.exposition();
+            if (!out) {
+                std::cerr << "Falha ao gravar as métricas: " << temporary << std::endl;
+                return;
+            }
+        }
+        std::remove(filePath.c_str());  // No Windows, rename não substitui um arquivo existente.
+        std::rename(temporary.c_str(), filePath.c_str());
+    }
+
+#ifdef __linux__
+    static int openSocket(const std::string& path) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Caminho do socket de métricas muito longo: " << path << std::endl;
+            return -1;
+        }
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        unlink(path.c_str());  // Socket que sobrou de uma execução anterior.
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 4) < 0) {
+            std::cerr << "Falha ao abrir o socket de métricas: " << path << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Responde uma conexão com a exposição atual, em uma resposta HTTP mínima.
+    void serveConnection() {
+        int client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0)
+            return;
+        // Descarta o pedido (se houver) sem esperar por ele.
+        pollfd fd = { client, POLLIN, 0 };
+        char request[1024];
+        if (::poll(&fd, 1, 50) > 0) {
+            ssize_t ignored = read(client, request, sizeof(request));
+            (void)ignored;
+        }
+
+        std::string body = registry.exposition();
+        std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                               std::to_string(body.size()) + "\r\n\r\n" + body;
+        const char* data = response.data();
+        size_t remaining = response.size();
+        while (remaining > 0) {
+            ssize_t written = send(client, data, remaining, MSG_NOSIGNAL);
+            if (written <= 0)
+                break;
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        close(client);
+    }
+
+    int listenFd = -1;
+#endif
+
+    const MetricsRegistry& registry;
+    const std::string filePath;
+    const std::string socketPath;
+    const std::chrono::seconds interval;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
@@ -0,0 +1,213 @@
+#pragma once
+
+// Perfilador de zonas por quadro (opção PERFILADOR do CMake).
+// PROFILE_ZONE("nome") mede o tempo até o fim do escopo atual e grava a zona no buffer circular da thread,
+// sem travas: cada thread só escreve no próprio buffer. Com F12 (ou SIGUSR1, onde existir) os últimos
+// segundos de todas as threads são gravados em perfil.json, no formato de trace do Chrome
+// (abrir em chrome://tracing ou ui.perfetto.dev).
+// Sem PERFILADOR as macros não geram código e profilerRequestDump() não faz nada.
+// Os nomes das zonas devem ser literais de string (apenas o ponteiro é guardado).
+
+#ifdef PERFILADOR
+
+#include <algorithm>  // min, remove_if.
+#include <atomic>  // Índice de escrita dos buffers e pedido de gravação.
+#include <chrono>  // Relógio dos carimbos de tempo.
+#include <csignal>  // SIGUSR1.
+#include <cstdint>  // int64_t, uint64_t.
+#include <fstream>  // Gravação do trace.
+#include <iomanip>  // Formatação dos tempos em microssegundos.
+#include <memory>  // unique_ptr dos buffers.
+#include <mutex>  // Registro de threads (apenas na primeira zona de cada thread).
+#include <string>  // Caminho do arquivo e nomes de threads.
+#include <vector>  // Buffers registrados e cópia para gravação.
+
+// Mesmo relógio de clockNowNs() (input.h), repetido aqui para não criar dependência circular.
+inline int64_t profilerNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Uma zona medida, em nanossegundos.
+struct ProfileEvent {
+    const char* name;
+    int64_t startNs;
+    int64_t endNs;
+};
+
+constexpr uint64_t roundUpToPowerOfTwo(uint64_t value) {
+    uint64_t power = 1;
+    while (power < value)
+        power <<= 1;
+    return power;
+}
+
+// Buffer circular de zonas de uma thread. Só a thread dona escreve; a gravação lê de outra thread e
+// descarta as posições que foram sobrescritas durante a cópia.
+class ProfileThreadBuffer {
+public:
+    // Dimensionado para 10 s da thread principal: três zonas por passo de simulação ("passo",
+    // "Bird::update" e "Pipe::update/isColliding", a 2000 passos/s, o ticks_per_second de game.h) mais até
+    // seis zonas por quadro a 240 Hz, arredondado para potência de dois (a máscara de índice exige).
+    static constexpr uint64_t zonesPerSecond = 3 * 2000 + 6 * 240;
+    static constexpr uint64_t capacity = roundUpToPowerOfTwo(10 * zonesPerSecond);
+
+    explicit ProfileThreadBuffer(int id) : id(id), events(new ProfileEvent[capacity]) {}
+
+    void push(const char* name, int64_t startNs, int64_t endNs) {
+        uint64_t index = writeIndex.load(std::memory_order_relaxed);
+        events[index & (capacity - 1)] = ProfileEvent{ name, startNs, endNs };
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    // Copia as zonas que começaram a partir de sinceNs.
+    void snapshot(int64_t sinceNs, std::vector<ProfileEvent>& out) const {
+        uint64_t end = writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > capacity ? end - capacity : 0;
+        size_t first = out.size();
+        for (uint64_t i = begin; i < end; ++i)
+            out.push_back(events[i & (capacity - 1)]);
+
+        // Descarta o que a thread dona sobrescreveu enquanto copiávamos.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = writeIndex.load(std::memory_order_relaxed);
+        uint64_t valid = after > capacity ? after - capacity : 0;
+        if (valid > begin)
+            out.erase(out.begin() + first, out.begin() + first + static_cast<size_t>(std::min(valid, end) - begin));
+        out.erase(std::remove_if(out.begin() + first, out.end(), [sinceNs](const ProfileEvent& e) { return e.startNs < sinceNs; }), out.end());
+    }
+
+    const int id;  // tid no trace.
+    std::string name;  // Nome da thread no trace (PROFILE_THREAD).
+
+private:
+    std::unique_ptr<ProfileEvent[]> events;
+    std::atomic<uint64_t> writeIndex{ 0 };
+};
+
+class Profiler {
+public:
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // Buffer da thread atual, criado na primeira zona. Os buffers vivem até o fim do programa para que
+    // as zonas de threads já encerradas continuem aparecendo no trace.
+    ProfileThreadBuffer& threadBuffer() {
+        thread_local ProfileThreadBuffer* buffer = nullptr;
+        if (!buffer)
+            buffer = &createTrack(nullptr);
+        return *buffer;
+    }
+
+    // Cria uma linha no trace que não corresponde a uma thread (ex.: os tempos da GPU, gpu_profiler.h).
+    // Apenas uma thread pode escrever nela.
+    ProfileThreadBuffer& createTrack(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffers.emplace_back(new ProfileThreadBuffer(static_cast<int>(buffers.size()) + 1));
+        if (name)
+            buffers.back()->name = name;
+        return *buffers.back();
+    }
+
+    void setThreadName(const char* name) {
+        ProfileThreadBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.name = name;
+    }
+
+    // Pede a gravação do trace. Pode ser chamado de um tratador de sinal.
+    void requestDump() {
+        dumpRequested.store(true, std::memory_order_relaxed);
+    }
+
+    // Retorna true (uma única vez) se houve pedido de gravação desde a última chamada.
+    bool takeDumpRequest() {
+        return dumpRequested.exchange(false, std::memory_order_relaxed);
+    }
+
+    // Grava as zonas dos últimos seconds segundos de todas as threads em formato de trace do Chrome.
+    bool dump(const std::string& path, double seconds) {
+        const int64_t nowNs = profilerNowNs();
+        return dump(path, nowNs - static_cast<int64_t>(seconds * 1e9), nowNs);
+    }
+
+    // Grava as zonas que começaram entre sinceNs e untilNs (relógio de profilerNowNs).
+    bool dump(const std::string& path, int64_t sinceNs, int64_t untilNs) {
+        std::ofstream out(path);
+        if (!out)
+            return false;
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out << std::fixed << std::setprecision(3);
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Flappy Bird\"}}";
+
+        std::vector<ProfileEvent> events;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& buffer : buffers) {
+            std::string threadName = buffer->name.empty() ? "thread " + std::to_string(buffer->id) : buffer->name;
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+
+            events.clear();
+            buffer->snapshot(sinceNs, events);
+            for (const auto& event : events) {
+                if (event.startNs > untilNs)
+                    continue;
+                // O trace usa microssegundos; três casas decimais preservam os nanossegundos.
+                out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                    << ",\"ts\":" << (event.startNs - sinceNs) / 1e3 << ",\"dur\":" << (event.endNs - event.startNs) / 1e3 << "}";
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+    // Faz SIGUSR1 pedir a gravação do trace (apenas em sistemas POSIX).
+    void installSignalHandler() {
+#ifdef SIGUSR1
+        std::signal(SIGUSR1, [](int) { Profiler::instance().requestDump(); });
+#endif
+    }
+
+private:
+    Profiler() = default;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProfileThreadBuffer>> buffers;
+    std::atomic<bool> dumpRequested{ false };
+};
+
+// Mede o tempo de vida do objeto e grava a zona ao sair do escopo.
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name(name), startNs(profilerNowNs()) {}
+
+    ~ProfileZone() {
+        Profiler::instance().threadBuffer().push(name, startNs, profilerNowNs());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    int64_t startNs;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::instance().setThreadName(name)
+
+inline void profilerRequestDump() {
+    Profiler::instance().requestDump();
+}
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+
+inline void profilerRequestDump() {}
+
+#endif
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>  // int64_t, uint32_t.
+#include <fstream>  // Leitura e gravação da linha de base.
+#include <iomanip>  // Formatação do relatório.
+#include <iostream>  // Relatório no console.
+#include <string>  // Caminhos e nome do renderizador.
+#include "frame_stats.h"  // HdrHistogram.
+
+// Resultado de referência do benchmark de renderização (--benchmark-render), gravado com
+// --gravar-linha-de-base e comparado com --linha-de-base. Só faz sentido comparar resultados da mesma
+// máquina e do mesmo renderizador; o nome do renderizador é guardado para avisar quando eles diferem.
+// Formato do arquivo (texto, tempos em nanossegundos):
+//   flappy-render 1
+//   quadros <n>
+//   semente <n>
+//   p50 <ns>
+//   p95 <ns>
+//   p99 <ns>
+//   renderizador <GL_RENDERER até o fim da linha>
+struct RenderBaseline {
+    int frames = 0;
+    uint32_t seed = 0;
+    int64_t p50Ns = 0, p95Ns = 0, p99Ns = 0;  // Percentis do tempo total de quadro.
+    std::string renderer;
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Falha ao gravar a linha de base: " << path << std::endl;
+            return false;
+        }
+        out << "flappy-render 1\n";
+        out << "quadros " << frames << "\n";
+        out << "semente " << seed << "\n";
+        out << "p50 " << p50Ns << "\np95 " << p95Ns << "\np99 " << p99Ns << "\n";
+        out << "renderizador " << renderer << "\n";
+        return static_cast<bool>(out);
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        std::string magic, key;
+        int version = 0;
+        if (!(in >> magic >> version) || magic != "flappy-render" || version != 1) {
+            std::cerr << "Linha de base inválida: " << path << std::endl;
+            return false;
+        }
+        if (!(in >> key >> frames >> key >> seed >> key >> p50Ns >> key >> p95Ns >> key >> p99Ns >> key)) {
+            std::cerr << "Linha de base inválida: " << path << std::endl;
+            return false;
+        }
+        std::getline(in >> std::ws, renderer);
+        return true;
+    }
+};
+
+// Tempos de cada quadro do benchmark de renderização: CPU (simulação e envio dos comandos), GPU (consulta
+// GL_TIME_ELAPSED, quando disponível) e total (do início do quadro ao fim do glFinish). No llvmpipe a
+// "GPU" também roda na CPU, em outras threads, por isso o portão de regressão usa o tempo total.
+class RenderBenchmark {
+public:
+    void onFrame(int64_t cpuNs, int64_t gpuNs, int64_t frameNs) {
+        cpu.record(cpuNs);
+        if (gpuNs >= 0)
+            gpu.record(gpuNs);
+        total.record(frameNs);
+    }
+
+    RenderBaseline baseline(uint32_t seed, const std::string& renderer) const {
+        RenderBaseline result;
+        result.frames = static_cast<int>(total.count());
+        result.seed = seed;
+        result.p50Ns = static_cast<int64_t>(total.percentile(50));
+        result.p95Ns = static_cast<int64_t>(total.percentile(95));
+        result.p99Ns = static_cast<int64_t>(total.percentile(99));
+        result.renderer = renderer;
+        return result;
+    }
+
+    void report(std::ostream& out) const {
+        out << "Tempos por quadro (ms)      p50      p95      p99      max" << std::endl;
+        printLine(out, "CPU                   ", cpu);
+        if (gpu.count() > 0)
+            printLine(out, "GPU                   ", gpu);
+        else
+            out << "GPU                    (GL_TIME_ELAPSED indisponível)" << std::endl;
+        printLine(out, "total                 ", total);
+    }
+
+    // Compara o p95 do tempo total com a linha de base. Retorna 1 se ele piorou mais que tolerancePct por cento.
+    int check(const RenderBaseline& reference, const std::string& renderer, double tolerancePct, std::ostream& out) const {
+        if (reference.renderer != renderer)
+            out << "Aviso: a linha de base foi medida em \"" << reference.renderer << "\", não em \"" << renderer << "\"." << std::endl;
+        const double p95 = static_cast<double>(total.percentile(95));
+        const double change = reference.p95Ns > 0 ? (p95 / reference.p95Ns - 1.0) * 100.0 : 0.0;
+        const std::streamsize precision = out.precision();
+        out << std::fixed << std::setprecision(3) << "p95 " << p95 / 1e6 << " ms contra " << reference.p95Ns / 1e6
+            << " ms na linha de base (" << std::showpos << std::setprecision(1) << change << std::noshowpos
+            << "%, tolerância " << tolerancePct << "%)." << std::endl;
+        out.unsetf(std::ios::floatfield);
+        out.precision(precision);
+        if (change > tolerancePct) {
+            out << "REGRESSÃO no tempo de quadro." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+private:
+    static void printLine(std::ostream& out, const char* name, const HdrHistogram& histogram) {
+        const std::streamsize precision = out.precision();
+        out << name << std::fixed << std::setprecision(3)
+            << std::setw(9) << histogram.percentile(50) / 1e6 << std::setw(9) << histogram.percentile(95) / 1e6
+            << std::setw(9) << histogram.percentile(99) / 1e6 << std::setw(9) << histogram.max() / 1e6 << std::endl;
+        out.unsetf(std::ios::floatfield);
+        out.precision(precision);
+    }
+
+    HdrHistogram cpu, gpu, total;
+};
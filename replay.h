@@ -0,0 +1,140 @@
+#pragma once
+
+#include <chrono>  // Medição da velocidade da reprodução.
+#include <cstdint>  // int64_t, uint32_t, uint64_t.
+#include <fstream>  // Leitura e gravação do arquivo de partida.
+#include <iomanip>  // Hash em hexadecimal.
+#include <iostream>  // Relatório no console.
+#include <string>  // Caminhos e palavras-chave do arquivo.
+#include <vector>  // Lista de ações gravadas.
+#include "game.h"  // World.
+#include "input.h"  // InputAction.
+
+// Ação do jogador aplicada antes do passo de simulação indicado.
+struct ReplayEvent {
+    int64_t tick;
+    InputAction action;
+};
+
+// Partida gravada (--gravar) ou a reproduzir (--reproduzir). Como a simulação é determinística, basta
+// guardar a semente e os passos em que cada ação foi aplicada; o hash do estado final permite conferir
+// se a reprodução chegou exatamente ao mesmo resultado.
+// A colisão depende da máscara do pássaro (collision_mask.h), então o arquivo guarda o hash dela; 0 indica
+// o quadrado 30x30 (e é o valor das gravações da versão 1, anteriores à máscara). A versão 3 guarda também
+// a configuração da fase (LevelConfig); as anteriores são da fase original. A versão 4 acrescenta à linha
+// da fase se os tubos são validados (LevelConfig::reachable); na versão 3 não eram.
+// Formato do arquivo (texto):
+//   flappy-replay 4
+//   semente <n>
+//   passos <n>
+//   hash <hexadecimal>
+//   mascara <hexadecimal>
+//   fase <0 original, 1 contínua> <espaço mín> <espaço máx> <altura mín> <altura máx> <variação> <bloco> <validada>
+//   F <passo>   (uma linha por batida de asas)
+//   R <passo>   (uma linha por reinício)
+struct Replay {
+    uint32_t seed = 0;
+    int64_t ticks = 0;  // Passos executados na partida.
+    uint64_t hash = 0;  // World::hash() no fim da partida.
+    uint64_t maskHash = 0;  // CollisionMask::hash() da máscara do pássaro, ou 0 sem máscara.
+    LevelConfig level;
+    std::vector<ReplayEvent> events;
+
+    void record(int64_t tick, InputAction action) {
+        events.push_back(ReplayEvent{ tick, action });
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Falha ao gravar a partida: " << path << std::endl;
+            return false;
+        }
+        out << "flappy-replay 4\n";
+        out << "semente " << seed << "\n";
+        out << "passos " << ticks << "\n";
+        out << "hash " << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << "\n";
+        out << "mascara " << std::hex << std::setw(16) << std::setfill('0') << maskHash << std::dec << "\n";
+        out << std::setprecision(9) << "fase " << (level.endless ? 1 : 0) << " " << level.minSpacing << " " << level.maxSpacing
+            << " " << level.minHeight << " " << level.maxHeight << " " << level.maxStep << " " << level.chunk << " " << (level.reachable ? 1 : 0) << "\n";
+        for (const auto& event : events)
+            out << (event.action == InputAction::Flap ? 'F' : 'R') << " " << event.tick << "\n";
+        return static_cast<bool>(out);
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        std::string magic, key;
+        int version = 0;
+        if (!(in >> magic >> version) || magic != "flappy-replay" || version < 1 || version > 4) {
+            std::cerr << "Arquivo de partida inválido: " << path << std::endl;
+            return false;
+        }
+        in >> key >> seed >> key >> ticks >> key >> std::hex >> hash >> std::dec;
+        maskHash = 0;
+        if (version >= 2)
+            in >> key >> std::hex >> maskHash >> std::dec;
+        level = LevelConfig();
+        if (version >= 3) {
+            int endless = 0;
+            in >> key >> endless >> level.minSpacing >> level.maxSpacing >> level.minHeight >> level.maxHeight
+               >> level.maxStep >> level.chunk;
+            level.endless = endless != 0;
+            int reachable = 0;
+            if (version >= 4)
+                in >> reachable;
+            level.reachable = reachable != 0;
+        }
+
+        events.clear();
+        char action;
+        int64_t tick;
+        while (in >> action >> tick) {
+            if (action != 'F' && action != 'R')
+                break;
+            record(tick, action == 'F' ? InputAction::Flap : InputAction::Reset);
+        }
+        if (!in.eof()) {
+            std::cerr << "Arquivo de partida inválido: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+// Reproduz a partida sem janela nem relógio, o mais rápido possível, e confere o hash do estado final.
+// mask é a máscara do pássaro deste executável; partidas gravadas sem máscara são reproduzidas sem ela.
+// Retorna 0 se o resultado bate com o gravado.
+inline int playReplay(const Replay& replay, const CollisionMask* mask, std::ostream& out) {
+    World world(replay.seed, replay.level);
+    if (replay.maskHash != 0) {
+        if (!mask || mask->hash() != replay.maskHash) {
+            out << "A partida foi gravada com outra máscara de colisão (sprite diferente); não é possível reproduzi-la." << std::endl;
+            return 1;
+        }
+        world.bird.mask = mask;
+    }
+    size_t next = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (world.tick < replay.ticks) {
+        while (next < replay.events.size() && replay.events[next].tick <= world.tick)
+            world.apply(replay.events[next++].action);
+        world.step();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double gameSeconds = static_cast<double>(replay.ticks) / ticks_per_second;
+    out << "Reprodução: " << replay.ticks << " passos (" << gameSeconds << " s de jogo) em " << elapsed.count() * 1000.0
+        << " ms, " << (elapsed.count() > 0.0 ? gameSeconds / elapsed.count() : 0.0) << "x o tempo real." << std::endl;
+
+    uint64_t hash = world.hash();
+    out << "Hash final " << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << std::setfill(' ');
+    if (hash != replay.hash) {
+        out << ": DIFERENTE do gravado (" << std::hex << std::setw(16) << std::setfill('0') << replay.hash << std::dec
+            << std::setfill(' ') << ")." << std::endl;
+        return 1;
+    }
+    out << ": igual ao gravado." << std::endl;
+    return 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>  // int64_t.
+#include <iomanip>  // Formatação do relatório.
+#include <iostream>  // Relatório no console.
+#include "input.h"  // clockNowNs().
+
+// Instantes de cada etapa da inicialização, do início de main() até o primeiro quadro completo (opção
+// --tempo-inicializacao). Nos quiosques, que reiniciam toda noite, é o tempo de janela preta que o jogador vê.
+// O relatório tem uma linha por etapa com o nome (sem espaços), a duração da etapa e o tempo acumulado em ms;
+// o BenchmarkInicializacao (tools/benchmark_startup.cpp) lê essas linhas.
+class StartupTimeline {
+public:
+    explicit StartupTimeline(int64_t startNs) : startNs(startNs) {}
+
+    // Marca o fim da etapa phase (nome constante, sem espaços).
+    void mark(const char* phase) {
+        if (count == maxPhases)
+            return;
+        names[count] = phase;
+        times[count] = clockNowNs();
+        ++count;
+    }
+
+    void report(std::ostream& out) const {
+        const std::streamsize precision = out.precision();
+        out << "Inicialização (ms)              etapa  acumulado" << std::endl;
+        int64_t previousNs = startNs;
+        for (int i = 0; i < count; ++i) {
+            out << "  " << std::left << std::setw(26) << names[i] << std::right << std::fixed << std::setprecision(3)
+                << std::setw(10) << (times[i] - previousNs) / 1e6 << std::setw(11) << (times[i] - startNs) / 1e6 << std::endl;
+            previousNs = times[i];
+        }
+        out.unsetf(std::ios::floatfield);
+        out.precision(precision);
+    }
+
+private:
+    static const int maxPhases = 16;
+    const int64_t startNs;
+    const char* names[maxPhases] = {};
+    int64_t times[maxPhases] = {};
+    int count = 0;
+};
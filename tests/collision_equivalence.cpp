@@ -0,0 +1,290 @@
+// Equivalência da colisão (ctest): collideBatch com SIMD, sem SIMD e Pipe::isColliding pássaro a pássaro,
+// e CollisionMask::overlapsPipe contra um teste pixel a pixel da máscara amostrada do sprite. Cobre os casos
+// de borda: populações que não são múltiplo de 64 nem da largura do vetor, os bits do fim da última palavra
+// de dead (além de count), todas as alturas de tubo do jogo com o pássaro a cada 1/16 de pixel e imagens de
+// origem com largura e altura que não são múltiplo de 64. Também confere a varredura e poda da BirdSweep
+// contra o teste de todos os pares.
+// Uso: TesteColisao
+#include <algorithm>  // sort.
+#include <cmath>  // nextafter, INFINITY.
+#include <cstdint>  // uint64_t.
+#include <iostream>  // Resultado no console.
+#include <vector>  // Alturas, bits e pixels.
+#include "batch_collision.h"  // collideBatch.
+#include "broadphase.h"  // BirdSweep.
+
+// Sprite de width x height pixels: um círculo com ruído na borda, como os cantos transparentes de pinto.png.
+std::vector<unsigned char> spritePixels(int width, int height, uint32_t seed) {
+    GameRng rng(seed);
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const float dx = (x + 0.5f) / width - 0.5f, dy = (y + 0.5f) / height - 0.5f;
+            const float distance = dx * dx + dy * dy;
+            const bool solid = distance < 0.16f || (distance < 0.25f && rng.next() % 2 == 0);
+            pixels[(static_cast<size_t>(y) * width + x) * 4 + 3] = solid ? 255 : static_cast<unsigned char>(rng.next() % 128);
+        }
+    }
+    return pixels;
+}
+
+// Referência de overlapsPipe: percorre os 30x30 pixels do pássaro, cada um com a amostra do centro do seu
+// quadrado na imagem, e testa o quadrado do pixel contra os dois retângulos do tubo.
+bool overlapsPixelByPixel(const std::vector<unsigned char>& pixels, int width, int height, float birdX, float birdY,
+                          float pipeX, float pipeHeight) {
+    const int size = CollisionMask::size;
+    const float left = birdX - 15.0f, bottom = birdY - 15.0f;
+    for (int r = 0; r < size; ++r) {
+        const int imageRow = static_cast<int>(std::floor((r + 0.5) * height / size));
+        for (int c = 0; c < size; ++c) {
+            const int imageColumn = static_cast<int>(std::floor((c + 0.5) * width / size));
+            if (pixels[(static_cast<size_t>(imageRow) * width + imageColumn) * 4 + 3] < 128)
+                continue;
+            const float x0 = left + c, x1 = x0 + 1.0f, y0 = bottom + r, y1 = y0 + 1.0f;
+            const bool columns = x0 < pipeX + 25.0f && x1 > pipeX - 25.0f;
+            if (columns && (y0 < pipeHeight || y1 > pipeHeight + 200.0f))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Máscaras de imagens com largura e altura fora dos múltiplos de 64 (e de 30): as posições são múltiplos
+// de 1/4 de pixel, em que as contas em float são exatas, então a referência pode ser comparada bit a bit.
+// Retorna o número de diferenças.
+int checkMasks() {
+    const int sizes[][2] = { { 1, 1 }, { 1, 97 }, { 30, 30 }, { 63, 31 }, { 64, 64 }, { 65, 29 }, { 100, 100 }, { 348, 348 }, { 130, 7 } };
+    const float birdX = 100.0f;
+    int differences = 0, tests = 0, hits = 0;
+    for (const auto& size : sizes) {
+        const int width = size[0], height = size[1];
+        const std::vector<unsigned char> pixels = spritePixels(width, height, static_cast<uint32_t>(width * 1000 + height));
+        const CollisionMask mask = CollisionMask::fromRgba(pixels.data(), width, height);
+        Bird bird;
+        bird.x = birdX;
+        for (float pipeHeight : { 150.0f, 150.25f, 151.75f }) {
+            for (int px = -180; px <= 180; ++px) {
+                const Pipe pipe(birdX + px / 4.0f, pipeHeight);
+                // Só as faixas em que o quadrado do pássaro cobre a borda de um dos tubos.
+                for (int py = -64; py <= 864; py = py == 64 ? 736 : py + 1) {
+                    bird.y = pipeHeight + py / 4.0f;
+                    bird.mask = nullptr;
+                    if (!pipe.isColliding(bird))
+                        continue;  // overlapsPipe supõe o teste de caixa positivo.
+                    const bool expected = overlapsPixelByPixel(pixels, width, height, bird.x, bird.y, pipe.x, pipe.height);
+                    if (mask.overlapsPipe(bird.x, bird.y, pipe.x, pipe.height) != expected) {
+                        if (++differences <= 5)
+                            std::cout << "  máscara " << width << "x" << height << ", pássaro y " << bird.y << ", tubo ("
+                                      << pipe.x << ", " << pipe.height << "): esperado " << expected << std::endl;
+                    }
+                    hits += expected;
+                    ++tests;
+                }
+            }
+        }
+    }
+    std::cout << "Máscaras: " << tests << " testes, " << hits << " colisões, " << differences << " diferenças." << std::endl;
+    return differences;
+}
+
+// collideBatch com e sem SIMD contra Pipe::isColliding para populações de 1 a 200 pássaros (todos os restos
+// de 64 e da largura do vetor), com alturas nos limites do tubo e seus vizinhos em float. A última palavra
+// de dead começa com bits marcados além de count e alguns pássaros já marcados: uns e outros não podem mudar.
+// Retorna o número de diferenças.
+int checkBatches(const CollisionMask& mask) {
+    const float birdX = 100.0f;
+    const float pipeXs[] = { 59.0f, std::nextafter(60.0f, 0.0f), 60.0f, 100.0f, std::nextafter(140.0f, 0.0f), 140.0f, 141.0f };
+    GameRng rng(48);
+    int differences = 0, tests = 0;
+    for (int count = 1; count <= 200; ++count) {
+        const float height = static_cast<float>(100 + rng.next() % 300) + (count % 3) / 3.0f;
+        std::vector<float> ys(count);
+        for (int i = 0; i < count; ++i) {
+            // Um terço perto de cada limite em y, um terço em qualquer lugar.
+            const float limit = i % 3 == 0 ? height + 15.0f : height + 185.0f;
+            float y = i % 3 == 2 ? static_cast<float>(rng.next() % 60000) / 100.0f : limit;
+            for (int step = static_cast<int>(rng.next() % 9) - 4; step != 0; step += step < 0 ? 1 : -1)
+                y = std::nextafter(y, step < 0 ? -INFINITY : INFINITY);
+            ys[i] = y;
+        }
+
+        const int words = (count + 63) / 64;
+        const uint64_t tail = count % 64 ? ~uint64_t(0) << (count % 64) : 0;  // Bits além de count.
+        for (const CollisionMask* m : { static_cast<const CollisionMask*>(nullptr), &mask }) {
+            for (float pipeX : pipeXs) {
+                const Pipe pipe(pipeX, height);
+                std::vector<uint64_t> preset(words), simd, scalar;
+                for (int w = 0; w < words; ++w)
+                    preset[w] = (uint64_t(rng.next()) << 32 | rng.next()) & (uint64_t(rng.next()) << 32 | rng.next());
+                preset[words - 1] = (preset[words - 1] & ~tail) | (pipeX == 100.0f ? tail : 0);
+                simd = scalar = preset;
+                collideBatch(ys.data(), count, birdX, pipe, simd.data(), m, true);
+                collideBatch(ys.data(), count, birdX, pipe, scalar.data(), m, false);
+
+                Bird bird;
+                bird.x = birdX;
+                bird.mask = m;
+                std::vector<uint64_t> expected = preset;
+                for (int i = 0; i < count; ++i) {
+                    bird.y = ys[i];
+                    if (pipe.isColliding(bird))
+                        expected[i / 64] |= uint64_t(1) << (i % 64);
+                }
+                for (int w = 0; w < words; ++w) {
+                    differences += simd[w] != expected[w];
+                    differences += scalar[w] != expected[w];
+                }
+                if (simd != expected || scalar != expected) {
+                    if (differences <= 10)
+                        std::cout << "  lote de " << count << ", tubo x " << pipeX << (m ? ", com máscara" : "") << std::endl;
+                }
+                ++tests;
+            }
+        }
+    }
+    std::cout << "Colisão em lote (" << batchCollisionIsa() << "): " << tests << " lotes, " << differences
+              << " palavras diferentes." << std::endl;
+    return differences;
+}
+
+// collideBatch com e sem SIMD contra Pipe::isColliding em todas as alturas de tubo do jogo (e as mesmas mais
+// um terço de pixel), com o tubo dentro, fora e nos limites da faixa do pássaro em x, o pássaro a cada 1/16 de
+// pixel de altura e os 32 valores de ponto flutuante vizinhos de cada limite em y, sem máscara e com mask.
+// Cada lote tem mais de 11 mil pássaros, fora dos múltiplos de 64. Retorna o número de diferenças.
+int64_t checkHeights(const CollisionMask& mask) {
+    const float birdX = 100.0f;
+    const float pipeXs[] = { 59.0f, std::nextafter(60.0f, 0.0f), 60.0f, std::nextafter(60.0f, 100.0f), 75.5f,
+                             100.0f, std::nextafter(140.0f, 0.0f), 140.0f, 141.0f };
+    int64_t differences = 0, tests = 0, hits = 0;
+    for (int h = 200; h < 800; ++h) {
+        const float height = h / 2 + (h % 2 ? 1.0f / 3.0f : 0.0f);
+        std::vector<float> ys;
+        for (int i = -50 * 16; i < 650 * 16; ++i)
+            ys.push_back(i / 16.0f);
+        for (float limit : { height + 15.0f, height + 185.0f }) {
+            float below = limit, above = limit;
+            ys.push_back(limit);
+            for (int i = 0; i < 32; ++i) {
+                ys.push_back(below = std::nextafter(below, -INFINITY));
+                ys.push_back(above = std::nextafter(above, INFINITY));
+            }
+        }
+        const int count = static_cast<int>(ys.size());
+        std::vector<uint64_t> simd((count + 63) / 64), scalar((count + 63) / 64);
+        for (const CollisionMask* m : { static_cast<const CollisionMask*>(nullptr), &mask }) {
+            for (float pipeX : pipeXs) {
+                const Pipe pipe(pipeX, height);
+                std::fill(simd.begin(), simd.end(), 0);
+                std::fill(scalar.begin(), scalar.end(), 0);
+                collideBatch(ys.data(), count, birdX, pipe, simd.data(), m, true);
+                collideBatch(ys.data(), count, birdX, pipe, scalar.data(), m, false);
+                Bird bird;
+                bird.x = birdX;
+                bird.mask = m;
+                for (int i = 0; i < count; ++i) {
+                    bird.y = ys[i];
+                    const bool expected = pipe.isColliding(bird);
+                    const bool simdHit = (simd[i / 64] >> (i % 64)) & 1, scalarHit = (scalar[i / 64] >> (i % 64)) & 1;
+                    if ((simdHit != expected || scalarHit != expected) && ++differences <= 5)
+                        std::cout << "  tubo (" << pipeX << ", " << height << "), pássaro y " << bird.y
+                                  << (m ? ", com máscara" : "") << ": esperado " << expected << std::endl;
+                    hits += expected;
+                    ++tests;
+                }
+            }
+        }
+    }
+    std::cout << "Alturas (" << batchCollisionIsa() << "): " << tests << " testes, " << hits << " colisões, "
+              << differences << " diferenças." << std::endl;
+    return differences;
+}
+
+// Índices dos pássaros em ordem crescente de x.
+std::vector<int> orderByX(const std::vector<Bird>& birds) {
+    std::vector<int> order(birds.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = static_cast<int>(i);
+    std::sort(order.begin(), order.end(), [&birds](int a, int b) { return birds[a].x < birds[b].x; });
+    return order;
+}
+
+// BirdSweep::collide contra Pipe::isColliding de cada pássaro com cada tubo, em 30 quadros em que os
+// pássaros andam em x (o bastante para trocar de lugar na ordem) e alguns já começam mortos e devem ser
+// pulados. Os tubos ficam em uma PipeRing que dá a volta no vetor, com espaços menores que pipe_reach para
+// que um pássaro encoste em dois tubos; metade dos pássaros usa a máscara. No quadro 20 a população muda de
+// tamanho e a ordem é refeita. Também confere o número de testes exatos (só os tubos próximos dos pássaros
+// vivos). Retorna o número de diferenças.
+int checkSweep(const CollisionMask& mask) {
+    GameRng rng(47);
+    const int pipeCount = 300, capacity = 320;
+    std::vector<Pipe> pipes(capacity, Pipe(0.0f, 0.0f));
+    int head = 250;
+    float x = 0.0f;
+    for (int p = 0; p < pipeCount; ++p) {
+        x += static_cast<float>(20 + rng.next() % 280);
+        pipes[(head + p) % capacity] = Pipe(x, static_cast<float>(100 + rng.next() % 300));
+    }
+    const PipeRing ring(pipes.data(), pipeCount, head, capacity);
+
+    std::vector<Bird> birds(3000);
+    for (size_t b = 0; b < birds.size(); ++b) {
+        birds[b].x = static_cast<float>(rng.next() % static_cast<uint32_t>(x + 100.0f)) - 50.0f;
+        birds[b].y = static_cast<float>(rng.next() % 60000) / 100.0f;
+        birds[b].mask = b % 2 ? &mask : nullptr;
+    }
+
+    BirdSweep sweep;
+    int differences = 0;
+    int64_t reordered = 0;  // Posições da ordem por x que mudaram de pássaro.
+    int64_t tests = 0, pairs = 0, deaths = 0;
+    for (int frame = 0; frame < 30; ++frame) {
+        if (frame == 20)
+            birds.resize(2500);
+        const int count = static_cast<int>(birds.size());
+        const std::vector<int> before = orderByX(birds);
+        for (Bird& bird : birds)
+            bird.x += static_cast<float>(static_cast<int>(rng.next() % 161) - 80) / 2.0f;
+        const std::vector<int> after = orderByX(birds);
+        for (int i = 0; i < count; ++i)
+            reordered += before[i] != after[i];
+
+        std::vector<unsigned char> preset(count), dead, expected;
+        for (int b = 0; b < count; ++b)
+            preset[b] = rng.next() % 10 == 0;
+        dead = expected = preset;
+        sweep.sort(birds.data(), count);
+        const int frameTests = sweep.collide(birds.data(), ring, dead.data());
+        tests += frameTests;
+
+        // Os testes exatos esperados: os tubos a menos de pipe_reach de cada pássaro vivo, até a primeira
+        // colisão. Um pássaro morto testado a mais também muda a contagem.
+        int64_t expectedTests = 0;
+        for (int b = 0; b < count; ++b) {
+            for (int p = 0; p < ring.size() && !expected[b]; ++p) {
+                const bool near = ring.at(p).x > birds[b].x - pipe_reach && ring.at(p).x < birds[b].x + pipe_reach;
+                expectedTests += near ? 1 : 0;
+                expected[b] = ring.at(p).isColliding(birds[b]) ? 1 : 0;
+                if (expected[b] && !near && ++differences <= 5)
+                    std::cout << "  quadro " << frame << ", pássaro " << b << ": colisão além de pipe_reach" << std::endl;
+            }
+            pairs += ring.size();
+            deaths += expected[b] && !preset[b];
+            if (dead[b] != expected[b] && ++differences <= 5)
+                std::cout << "  quadro " << frame << ", pássaro " << b << " (" << birds[b].x << ", " << birds[b].y
+                          << "): esperado " << int(expected[b]) << std::endl;
+        }
+        if (frameTests != expectedTests && ++differences <= 5)
+            std::cout << "  quadro " << frame << ": " << frameTests << " testes exatos, esperados " << expectedTests << std::endl;
+    }
+    std::cout << "Varredura e poda: " << deaths << " colisões, " << tests << " testes exatos (" << pairs
+              << " pares), " << reordered << " mudanças na ordem, " << differences << " diferenças." << std::endl;
+    return differences;
+}
+
+int main() {
+    const std::vector<unsigned char> sprite = spritePixels(65, 63, 7);
+    const CollisionMask mask = CollisionMask::fromRgba(sprite.data(), 65, 63);
+    const int64_t failures = checkMasks() + checkBatches(mask) + checkHeights(mask) + checkSweep(mask);
+    std::cout << (failures == 0 ? "OK" : "FALHOU") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+// Regressão da simulação (ctest): reproduz partidas gravadas antes da colisão contínua de World::advance
+// (tests/replays) e confere o hash final de cada uma, e confere um passo de raspão em que só o teste
+// contínuo acharia colisão. Um passo de step() deve continuar testando apenas a posição final.
+// Uso: TesteReproducao <pinto.png> <partida>...
+#include <iostream>  // Resultado no console.
+#include "replay.h"  // Replay, playReplay.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"  // Máscara do pássaro a partir do sprite.
+
+// O pássaro sai da coluna do tubo 0 (à esquerda) no meio do passo e só depois desce abaixo da abertura:
+// as posições inicial e final não colidem, o caminho entre elas sim. Retorna o número de falhas.
+int checkGraze() {
+    int failures = 0;
+    for (int ticks = 1; ticks <= 2; ++ticks) {
+        World world(31);
+        world.pipe(0).reset(60.0235f, 300.0f);
+        world.pipe(1).reset(400.0f, 300.0f);
+        world.pipe(2).reset(700.0f, 300.0f);
+        world.bird.y = 315.0118f;
+        world.bird.velocity = -0.1066f;
+        if (ticks == 1)
+            world.step();
+        else
+            world.advance(ticks);  // Vários passos de uma vez: o teste contínuo deve achar o raspão.
+        const bool expected = ticks > 1;
+        if (world.gameOver != expected) {
+            std::cout << "Raspão com " << ticks << " passo(s): " << (world.gameOver ? "colidiu" : "não colidiu")
+                      << ", esperado o contrário." << std::endl;
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " <pinto.png> <partida>..." << std::endl;
+        return 1;
+    }
+    int width, height, channels;
+    unsigned char* pixels = stbi_load(argv[1], &width, &height, &channels, 4);
+    if (!pixels) {
+        std::cerr << "Falha ao carregar " << argv[1] << std::endl;
+        return 1;
+    }
+    const CollisionMask mask = CollisionMask::fromRgba(pixels, width, height);
+    stbi_image_free(pixels);
+
+    int failures = checkGraze();
+    for (int i = 2; i < argc; ++i) {
+        Replay replay;
+        std::cout << argv[i] << std::endl;
+        if (!replay.load(argv[i]) || playReplay(replay, &mask, std::cout) != 0)
+            ++failures;
+    }
+    std::cout << (failures == 0 ? "OK" : "FALHOU") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
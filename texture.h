@@ -0,0 +1,483 @@
+#pragma once
+
+#include <GL/glew.h>  // Biblioteca para facilitar o uso de extensões do OpenGL.
+#include <iostream>  // Biblioteca padrão C++ para entrada e saída.
+#include <cstring>  // Biblioteca para manipulação de strings C, como strcmp().
+#include <string>  // Caminhos das texturas pedidas ao carregador assíncrono.
+#include <vector>  // Lista das threads de decodificação.
+#include <deque>  // Filas de pedidos e de imagens decodificadas.
+#include <memory>  // shared_ptr para o estado compartilhado das texturas.
+#include <atomic>  // Estado "pronta" lido fora da thread de renderização.
+#include <mutex>  // Proteção das filas.
+#include <condition_variable>  // Acorda as threads de decodificação.
+#include <thread>  // Threads de decodificação.
+#include <unordered_map>  // Cache de texturas por caminho.
+#include <cstdint>  // Numeração dos pedidos de cada textura.
+#include "stb_image.h"  // Biblioteca para carregar imagens.
+#include "dds.h"  // Leitura de texturas comprimidas BC1/BC3 (.dds).
+#include "collision_mask.h"  // Máscara de colisão tirada da mesma decodificação.
+#include "profiler.h"  // Zonas do perfilador.
+#include "alloc_tracker.h"  // Alocações atribuídas ao carregador.
+
+// Envia todos os níveis de uma imagem .dds para a textura vinculada.
+// Se o driver não suportar S3TC, os blocos são decodificados para RGBA8 antes do envio.
+inline void uploadCompressedLevels(const DdsImage& image) {
+    bool s3tc = GLEW_EXT_texture_compression_s3tc;
+    GLenum format = image.hasAlpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // Níveis pequenos (ex.: 1x1 RGBA) não são alinhados a 4 bytes.
+    for (size_t i = 0; i < image.levels.size(); ++i) {
+        const DdsLevel& level = image.levels[i];
+        if (s3tc) {
+            // Envia os blocos comprimidos diretamente, sem descompressão.
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), format, level.width, level.height, 0,
+                                   static_cast<GLsizei>(level.blocks.size()), level.blocks.data());
+        }
+        else {
+            std::vector<unsigned char> rgba = ddsDecodeLevel(level, image.hasAlpha);
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), GL_RGBA, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.levels.size() - 1));
+}
+
+// Indica se o caminho aponta para uma textura comprimida (.dds).
+inline bool isCompressedTexturePath(const char* filePath) {
+    size_t length = strlen(filePath);
+    return length > 4 && strcmp(filePath + length - 4, ".dds") == 0;
+}
+
+// Imagem decodificada em tempo de build e embutida no executável pelo EmbutirAssets (tools/embed_assets.cpp).
+struct EmbeddedImage {
+    const char* name;  // Nome do asset (chave no cache).
+    const char* sourcePath;  // Arquivo de origem usado no build.
+    int width, height;
+    const unsigned char* pixels;  // RGBA8, width * height * 4 bytes.
+};
+
+// Estado de uma textura pedida ao carregador assíncrono, compartilhado com os TextureHandle.
+struct TextureSlot {
+    GLuint texture = 0;  // ID da textura; 0 enquanto ela não foi enviada.
+    int width = 0, height = 0;  // Dimensões da imagem original.
+    std::string source;  // Arquivo de origem, usado para recarregar a textura quando ele muda.
+    bool compressed = false;  // true se o conteúdo atual veio de um .dds.
+    // Máscara de colisão do canal alfa, gerada com o conteúdo atual (só imagens RGBA: um .dds não tem).
+    // Só a thread de renderização usa estes campos.
+    CollisionMask mask;
+    bool hasMask = false;
+    // Pedidos (carga e recarregamentos) numerados na ordem em que foram feitos, e o último enviado. Um pedido
+    // mais antigo que o enviado é descartado: com várias threads auxiliares as decodificações terminam fora de
+    // ordem. Só a thread de renderização usa estes campos.
+    uint64_t requested = 0, uploaded = 0;
+    std::atomic<bool> ready{ false };  // true depois que a textura foi enviada ao OpenGL.
+    std::atomic<bool> failed{ false };  // true se a imagem não pôde ser carregada.
+};
+
+// Referência para uma textura que pode ainda estar carregando.
+// Enquanto ela não está pronta, get() devolve a textura provisória do carregador.
+class TextureHandle {
+public:
+    TextureHandle() = default;
+    TextureHandle(std::shared_ptr<TextureSlot> slot, GLuint placeholder) : slot(std::move(slot)), placeholder(placeholder) {}
+
+    // Textura a ser usada no desenho deste quadro.
+    GLuint get() const {
+        return ready() ? slot->texture : placeholder;
+    }
+
+    bool ready() const {
+        return slot && slot->ready.load(std::memory_order_acquire);
+    }
+
+    bool failed() const {
+        return slot && slot->failed.load(std::memory_order_acquire);
+    }
+
+    // Máscara de colisão da imagem, ou nullptr enquanto ela não está pronta (ou se não tem máscara). O
+    // ponteiro vale enquanto o handle existir, e o conteúdo acompanha os recarregamentos do arquivo.
+    const CollisionMask* collisionMask() const {
+        return ready() && slot->hasMask ? &slot->mask : nullptr;
+    }
+
+private:
+    std::shared_ptr<TextureSlot> slot;
+    GLuint placeholder = 0;
+};
+
+// Texturas cujo último TextureHandle já foi destruído. Como o handle pode morrer fora do contexto OpenGL,
+// os IDs são apenas guardados aqui e apagados pela thread de renderização no próximo update().
+struct TextureGarbage {
+    std::mutex mutex;
+    std::vector<GLuint> textures;
+};
+
+// Carregador de texturas assíncrono: as imagens são decodificadas em threads auxiliares e enviadas
+// ao OpenGL pela thread de renderização em update(), através de pixel buffer objects (PBO), respeitando
+// um limite de bytes por quadro para que carregar muitas imagens nunca trave um quadro inteiro.
+// Também funciona como cache: pedidos repetidos do mesmo caminho compartilham a mesma decodificação e o
+// mesmo ID de textura, que é apagado quando o último TextureHandle deixa de existir.
+// A thread auxiliar também gera da imagem decodificada a máscara de colisão (TextureHandle::collisionMask),
+// sem uma segunda leitura do arquivo.
+// Deve ser criado com o contexto OpenGL ativo e liberado com release() antes de destruí-lo.
+class AsyncTextureLoader {
+public:
+    explicit AsyncTextureLoader(unsigned workerCount = 0) {
+        // Textura provisória de 1x1 pixel cinza, exibida enquanto a imagem real carrega.
+        const unsigned char gray[4] = { 128, 128, 128, 255 };
+        glGenTextures(1, &placeholder);
+        glBindTexture(GL_TEXTURE_2D, placeholder);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        // PBOs fazem parte do OpenGL 2.1; sem eles o envio é feito direto da memória da aplicação.
+        usePbo = GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object;
+        if (usePbo)
+            glGenBuffers(2, pbos);
+
+        if (workerCount == 0) {
+            unsigned cores = std::thread::hardware_concurrency();
+            workerCount = cores > 2 ? (cores - 1 < 4 ? cores - 1 : 4) : 1;
+        }
+        for (unsigned i = 0; i < workerCount; ++i)
+            workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+    }
+
+    ~AsyncTextureLoader() {
+        stopWorkers();
+    }
+
+    // Encerra as threads e libera os objetos OpenGL do carregador. Deve ser chamado antes de destruir o contexto.
+    void release() {
+        stopWorkers();
+        collectGarbage();
+        if (usePbo)
+            glDeleteBuffers(2, pbos);
+        glDeleteTextures(1, &placeholder);
+        usePbo = false;
+        placeholder = 0;
+    }
+
+    AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+    // Pede o carregamento de uma imagem (.png, .jpg, .dds, etc.). Retorna imediatamente.
+    // Se o mesmo caminho ainda estiver em uso (carregando ou pronto), devolve a textura existente sem decodificar de novo.
+    TextureHandle load(const std::string& filePath) {
+        if (auto slot = findCached(filePath))
+            return TextureHandle(slot, placeholder);
+
+        Job job;
+        job.path = filePath;
+        job.slot = makeSlot(filePath);
+        job.slot->source = filePath;
+        job.request = ++job.slot->requested;
+        TextureHandle handle(job.slot, placeholder);
+        enqueue(std::move(job));
+        return handle;
+    }
+
+    // Decodifica novamente, em segundo plano, todas as texturas em uso que vieram do arquivo fornecido.
+    // O novo conteúdo é enviado para a mesma textura em update(), sem trocar o ID usado pelos handles.
+    void reloadFile(const std::string& filePath) {
+        for (const auto& entry : cache) {
+            std::shared_ptr<TextureSlot> slot = entry.second.lock();
+            if (!slot || slot->source != filePath)
+                continue;
+            Job job;
+            job.path = filePath;
+            job.slot = slot;
+            job.reload = true;
+            job.request = ++slot->requested;
+            enqueue(std::move(job));
+        }
+    }
+
+    // Cria a textura de uma imagem embutida no executável (EmbutirAssets). Não há leitura de disco nem
+    // decodificação: os pixels são enviados direto ao OpenGL e o handle já volta pronto.
+    TextureHandle loadEmbedded(const EmbeddedImage& image) {
+        std::string key = std::string("embedded:") + image.name;
+        if (auto slot = findCached(key))
+            return TextureHandle(slot, placeholder);
+
+        std::shared_ptr<TextureSlot> slot = makeSlot(key);
+        slot->source = image.sourcePath;
+        glGenTextures(1, &slot->texture);
+        glBindTexture(GL_TEXTURE_2D, slot->texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        setTextureParameters(GL_LINEAR);
+
+        slot->width = image.width;
+        slot->height = image.height;
+        slot->mask = CollisionMask::fromRgba(image.pixels, image.width, image.height);
+        slot->hasMask = true;
+        slot->ready.store(true, std::memory_order_release);
+        return TextureHandle(slot, placeholder);
+    }
+
+    // Envia ao OpenGL as imagens já decodificadas. Deve ser chamado uma vez por quadro, na thread de renderização.
+    // Sempre envia pelo menos uma imagem por chamada, mesmo que ela sozinha ultrapasse o limite.
+    void update(size_t byteBudget = 8 * 1024 * 1024) {
+        PROFILE_ZONE("AsyncTextureLoader::update");
+        ALLOCATION_SCOPE("texturas");
+        collectGarbage();
+
+        size_t uploaded = 0;
+        while (uploaded < byteBudget) {
+            Job job;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (decoded.empty())
+                    break;
+                job = std::move(decoded.front());
+                decoded.pop_front();
+                --inFlight;
+            }
+            uploaded += upload(job);
+        }
+    }
+
+    // Quantidade de texturas pedidas que ainda não foram enviadas ao OpenGL.
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return inFlight;
+    }
+
+    // Quantidade de imagens decodificadas desde a criação do carregador (pedidos atendidos pelo cache não contam).
+    size_t decodeCount() const {
+        return decodes.load(std::memory_order_relaxed);
+    }
+
+    // Quantidade de texturas distintas no cache (carregando ou prontas).
+    size_t cachedCount() const {
+        size_t count = 0;
+        for (const auto& entry : cache)
+            count += entry.second.expired() ? 0 : 1;
+        return count;
+    }
+
+private:
+    struct Job {
+        std::string path;
+        std::shared_ptr<TextureSlot> slot;
+        unsigned char* pixels = nullptr;  // RGBA8 decodificado por stb_image (imagens comuns).
+        CollisionMask mask;  // Gerada de pixels pela thread auxiliar.
+        DdsImage compressed;  // Blocos lidos do disco (arquivos .dds).
+        int width = 0, height = 0;
+        bool reload = false;  // true para substituir o conteúdo de uma textura já existente.
+        uint64_t request = 0;  // Número do pedido na textura (TextureSlot::requested).
+    };
+
+    // Coloca um pedido na fila das threads auxiliares.
+    void enqueue(Job&& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(std::move(job));
+            ++inFlight;
+        }
+        wake.notify_one();
+    }
+
+    // Procura uma textura ainda em uso no cache.
+    std::shared_ptr<TextureSlot> findCached(const std::string& key) const {
+        auto cached = cache.find(key);
+        return cached != cache.end() ? cached->second.lock() : nullptr;
+    }
+
+    // Cria o estado de uma nova textura e o registra no cache.
+    // O deleter não chama o OpenGL: apenas entrega o ID para ser apagado em update().
+    std::shared_ptr<TextureSlot> makeSlot(const std::string& key) {
+        std::shared_ptr<TextureGarbage> bin = garbage;
+        std::shared_ptr<TextureSlot> slot(new TextureSlot, [bin](TextureSlot* slot) {
+            if (slot->texture != 0) {
+                std::lock_guard<std::mutex> lock(bin->mutex);
+                bin->textures.push_back(slot->texture);
+            }
+            delete slot;
+        });
+        cache[key] = slot;
+        return slot;
+    }
+
+    // Configura filtragem e repetição da textura vinculada.
+    static void setTextureParameters(GLint minFilter) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    // Apaga as texturas que perderam o último usuário e remove suas entradas do cache.
+    void collectGarbage() {
+        std::vector<GLuint> textures;
+        {
+            std::lock_guard<std::mutex> lock(garbage->mutex);
+            textures.swap(garbage->textures);
+        }
+        if (textures.empty())
+            return;
+        glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (it->second.expired())
+                it = cache.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    // Encerra as threads auxiliares e descarta as imagens que não chegaram a ser enviadas.
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping)
+                return;
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+        workers.clear();
+
+        for (auto& job : decoded)
+            stbi_image_free(job.pixels);
+        decoded.clear();
+        requests.clear();
+    }
+
+    // Laço das threads auxiliares: lê e decodifica as imagens pedidas, sem nenhuma chamada OpenGL.
+    void workerLoop() {
+        PROFILE_THREAD("texturas");
+        ALLOCATION_SCOPE("texturas (decodificacao)");
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !requests.empty(); });
+                if (stopping)
+                    return;
+                job = std::move(requests.front());
+                requests.pop_front();
+            }
+
+            {
+                PROFILE_ZONE("decodificar");
+                if (isCompressedTexturePath(job.path.c_str())) {
+                    if (readDds(job.path.c_str(), job.compressed)) {
+                        job.width = job.compressed.levels[0].width;
+                        job.height = job.compressed.levels[0].height;
+                    }
+                }
+                else {
+                    int nrChannels;
+                    job.pixels = stbi_load(job.path.c_str(), &job.width, &job.height, &nrChannels, 4);  // Sempre RGBA.
+                    if (job.pixels)
+                        job.mask = CollisionMask::fromRgba(job.pixels, job.width, job.height);
+                }
+            }
+            decodes.fetch_add(1, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.push_back(std::move(job));
+        }
+    }
+
+    // Cria a textura de um pedido já decodificado. Retorna quantos bytes foram enviados.
+    // Se a textura já existe (recarregamento, ou a carga inicial chegando depois dele), a imagem vai para o
+    // mesmo ID, com glTexSubImage2D se o tamanho não mudou: os handles e o cache continuam válidos e nenhum ID
+    // é perdido sem glDeleteTextures.
+    size_t upload(Job& job) {
+        if (job.request < job.slot->uploaded) {
+            stbi_image_free(job.pixels);  // Uma versão mais nova do arquivo já foi enviada.
+            job.pixels = nullptr;
+            return 0;
+        }
+        if (!job.pixels && job.compressed.levels.empty()) {
+            std::cerr << "Failed to load texture: " << job.path << std::endl;
+            if (!job.reload)
+                job.slot->failed.store(true, std::memory_order_release);  // Ao recarregar, mantém a versão anterior.
+            return 0;
+        }
+
+        bool replacing = job.slot->texture != 0;
+        GLuint textureID = replacing ? job.slot->texture : 0;
+        if (!replacing)
+            glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        size_t bytes = 0;
+
+        if (job.pixels) {
+            bytes = static_cast<size_t>(job.width) * job.height * 4;
+            bool sameSize = replacing && !job.slot->compressed && job.width == job.slot->width && job.height == job.slot->height;
+            const void* source = job.pixels;
+            if (usePbo) {
+                // Copia os pixels para um PBO "órfão" e deixa o driver transferi-los para a textura sem bloquear.
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[nextPbo]);
+                nextPbo = (nextPbo + 1) % 2;
+                glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+                void* mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+                if (mapped) {
+                    memcpy(mapped, job.pixels, bytes);
+                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                    source = nullptr;  // Com o PBO vinculado, o ponteiro é um deslocamento dentro dele.
+                }
+                else {
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                }
+            }
+            if (sameSize)
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, job.width, job.height, GL_RGBA, GL_UNSIGNED_BYTE, source);
+            else
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, job.width, job.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+            if (usePbo)
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            setTextureParameters(GL_LINEAR);
+            stbi_image_free(job.pixels);
+            job.pixels = nullptr;
+            job.slot->compressed = false;
+            job.slot->mask = job.mask;
+            job.slot->hasMask = true;
+        }
+        else {
+            uploadCompressedLevels(job.compressed);
+            for (const auto& level : job.compressed.levels)
+                bytes += level.blocks.size();
+            setTextureParameters(GL_LINEAR_MIPMAP_LINEAR);
+            job.slot->compressed = true;
+            job.slot->hasMask = false;
+        }
+
+        std::cout << (job.reload ? "Imagem recarregada: " : "Imagem carregada: ") << job.path
+                  << ", Largura: " << job.width << ", Altura: " << job.height;
+        if (job.slot->compressed)
+            std::cout << ", Formato: " << (job.compressed.hasAlpha ? "BC3" : "BC1")
+                      << (GLEW_EXT_texture_compression_s3tc ? "" : " (decodificado, driver sem S3TC)");
+        std::cout << std::endl;
+        job.slot->texture = textureID;
+        job.slot->uploaded = job.request;
+        job.slot->width = job.width;
+        job.slot->height = job.height;
+        job.slot->ready.store(true, std::memory_order_release);
+        return bytes;
+    }
+
+    std::vector<std::thread> workers;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> requests;  // Pedidos aguardando decodificação.
+    std::deque<Job> decoded;  // Imagens decodificadas aguardando envio ao OpenGL.
+    size_t inFlight = 0;  // Pedidos ainda não enviados (em qualquer uma das filas ou em decodificação).
+    bool stopping = false;
+    std::atomic<size_t> decodes{ 0 };  // Decodificações feitas pelas threads auxiliares.
+
+    std::unordered_map<std::string, std::weak_ptr<TextureSlot>> cache;  // Texturas em uso, por caminho (só na thread de renderização).
+    std::shared_ptr<TextureGarbage> garbage = std::make_shared<TextureGarbage>();
+
+    GLuint placeholder = 0;  // Textura provisória.
+    GLuint pbos[2] = { 0, 0 };  // PBOs usados alternadamente no envio.
+    int nextPbo = 0;
+    bool usePbo = false;
+};
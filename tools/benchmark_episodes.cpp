@@ -0,0 +1,159 @@
+// Benchmark de escalabilidade: roda episódios independentes das regras do jogo (World, sem janela) em
+// 1 a N threads e mostra episódios por segundo, eficiência paralela e uma estimativa da banda de estado por
+// contagem de threads. Cada configuração roda duas vezes, com o estado por thread (contadores atualizados a cada passo)
+// contíguo e com cada thread em sua própria linha de cache; a diferença entre as duas mostra o custo do
+// falso compartilhamento.
+// Com --passos-por-avanco k > 1, cada episódio avança k passos por vez (World::advance) e a política decide
+// uma vez a cada k passos.
+// Uso: BenchmarkEpisodios [--episodios <m>] [--threads <n>] [--passos <máximo por episódio>] [--passos-por-avanco <k>]
+#include <atomic>  // Distribuição dos episódios entre as threads.
+#include <chrono>  // steady_clock.
+#include <cstdint>  // int64_t, uint64_t.
+#include <cstdlib>  // atoi.
+#include <cstring>  // strcmp.
+#include <iomanip>  // Formatação da tabela.
+#include <iostream>  // Tabela no console.
+#include <thread>  // Threads de trabalho.
+#include <vector>  // Lista de threads e contadores.
+#include "game.h"  // World.
+
+// Contadores de cada thread, atualizados a cada passo de simulação. Contíguos (24 bytes cada), até três threads dividem a mesma
+// linha de cache de 64 bytes e cada escrita invalida a cópia das outras.
+struct ThreadCounters {
+    std::atomic<uint64_t> ticks{ 0 };  // Atômico só para que o compilador não o mantenha em um registrador.
+    uint64_t score = 0;
+    uint64_t hash = 0;  // Soma de World::hash() no fim de cada episódio, para conferir o resultado.
+};
+
+// Os mesmos contadores preenchidos até 64 bytes: o contador escrito a cada avanço (ticks, no início) de
+// cada thread fica em uma linha de cache diferente, qualquer que seja o alinhamento do vetor.
+struct PaddedThreadCounters : ThreadCounters {
+    char pad[64 - sizeof(ThreadCounters)];
+};
+static_assert(sizeof(PaddedThreadCounters) == 64, "um contador por linha de cache");
+
+// Política simples que mantém o pássaro no ar: bate as asas quando ele está caindo abaixo da parte de baixo
+// da abertura do próximo tubo (mais uma margem).
+inline bool shouldFlap(const World& world) {
+    const Pipe* next = nullptr;
+    for (int i = 0; i < world.pipeCount && !next; ++i) {
+        if (world.pipe(i).x + 25.0f > world.bird.x - 15.0f)
+            next = &world.pipe(i);  // A fila está em ordem de x.
+    }
+    float target = next ? next->height + 60.0f : 300.0f;
+    return world.bird.velocity <= 0.0f && world.bird.y < target;
+}
+
+// Roda um episódio até o fim da partida ou maxTicks passos, acumulando nos contadores da thread.
+inline void runEpisode(uint32_t seed, int64_t maxTicks, int ticksPerAdvance, ThreadCounters& counters) {
+    World world(seed);
+    while (!world.gameOver && world.tick < maxTicks) {
+        if (shouldFlap(world))
+            world.apply(InputAction::Flap);
+        if (ticksPerAdvance > 1)
+            world.advance(ticksPerAdvance);
+        else
+            world.step();
+        // Escrita na memória a cada avanço: é o que expõe o falso compartilhamento.
+        counters.ticks.store(counters.ticks.load(std::memory_order_relaxed) + ticksPerAdvance, std::memory_order_relaxed);
+    }
+    counters.score += world.score;
+    counters.hash += world.hash();
+}
+
+struct RunResult {
+    double seconds;
+    uint64_t ticks, score, hash;
+};
+
+// Roda os episódios 0..episodes-1 em threadCount threads, tirando o próximo episódio de um contador atômico.
+template <typename Counters>
+RunResult run(int threadCount, int episodes, int64_t maxTicks, int ticksPerAdvance) {
+    std::vector<Counters> counters(threadCount);
+    std::atomic<int> nextEpisode(0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            for (int episode = nextEpisode.fetch_add(1); episode < episodes; episode = nextEpisode.fetch_add(1))
+                runEpisode(static_cast<uint32_t>(episode), maxTicks, ticksPerAdvance, counters[t]);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    RunResult result = { elapsed.count(), 0, 0, 0 };
+    for (int t = 0; t < threadCount; ++t) {
+        result.ticks += counters[t].ticks;
+        result.score += counters[t].score;
+        result.hash += counters[t].hash;
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int episodes = 2000;
+    int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+    int64_t maxTicks = 20000;  // 10 s de jogo.
+    int ticksPerAdvance = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--episodios") == 0 && i + 1 < argc)
+            episodes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            maxThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--passos") == 0 && i + 1 < argc)
+            maxTicks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--passos-por-avanco") == 0 && i + 1 < argc)
+            ticksPerAdvance = atoi(argv[++i]);
+        else {
+            std::cerr << "Opção desconhecida: " << argv[i] << std::endl;
+            std::cerr << "Uso: " << argv[0] << " [--episodios <m>] [--threads <n>] [--passos <máximo por episódio>] [--passos-por-avanco <k>]" << std::endl;
+            return 1;
+        }
+    }
+    maxThreads = maxThreads > 0 ? maxThreads : 1;
+    ticksPerAdvance = ticksPerAdvance < 1 ? 1 : (ticksPerAdvance > max_advance_ticks ? max_advance_ticks : ticksPerAdvance);
+
+    // Aquecimento (frequência da CPU, criação de threads) e referência para conferir os resultados.
+    const RunResult reference = run<PaddedThreadCounters>(1, episodes, maxTicks, ticksPerAdvance);
+    std::cout << episodes << " episódios, " << reference.ticks << " passos no total, " << reference.score << " pontos." << std::endl;
+
+    // Estimativa da banda de estado: cada chamada a step() ou advance() lê e escreve o World uma vez (com os
+    // três tubos da fase original, não a fila inteira nem o gerador da fase contínua), mais a escrita do
+    // contador da thread. Com --passos-por-avanco k há um acesso a cada k passos, não um por passo.
+    const double bytesPerAdvance = 2.0 * (sizeof(World) - sizeof(World::pipes) - sizeof(World::generator) + 3 * sizeof(Pipe))
+                                   + sizeof(uint64_t);
+    std::cout << "Threads  layout       episódios/s      passos/s   eficiência   estado est. (GB/s)   contíguo/alinhado" << std::endl;
+
+    double singleThreadRate[2] = { 0.0, 0.0 };
+    double paddedRate = 0.0;  // Do alinhado com o mesmo número de threads.
+    int failures = 0;
+    for (int threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        for (int padded = 1; padded >= 0; --padded) {
+            RunResult r = padded ? run<PaddedThreadCounters>(threads, episodes, maxTicks, ticksPerAdvance)
+                                 : run<ThreadCounters>(threads, episodes, maxTicks, ticksPerAdvance);
+            if (r.ticks != reference.ticks || r.score != reference.score || r.hash != reference.hash) {
+                std::cerr << "Resultado diferente com " << threads << " threads!" << std::endl;
+                ++failures;
+            }
+            double rate = episodes / r.seconds;
+            if (threads == 1)
+                singleThreadRate[padded] = rate;
+            double efficiency = rate / (threads * singleThreadRate[padded]);
+            if (padded)
+                paddedRate = rate;
+            std::cout << std::setw(7) << threads << "  " << (padded ? "alinhado " : "contíguo ") << std::fixed
+                      << std::setprecision(0) << std::setw(15) << rate << std::setw(14) << r.ticks / r.seconds
+                      << std::setprecision(1) << std::setw(12) << efficiency * 100.0 << "%"
+                      << std::setprecision(2) << std::setw(21) << r.ticks / ticksPerAdvance * bytesPerAdvance / r.seconds / 1e9;
+            if (!padded)
+                std::cout << std::setw(19) << rate / paddedRate;  // Abaixo de 1: falso compartilhamento.
+            std::cout << std::endl;
+        }
+        if (threads == maxThreads)
+            break;
+    }
+    return failures == 0 ? 0 : 1;
+}
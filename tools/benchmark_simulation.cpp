@@ -0,0 +1,359 @@
+// Micro-benchmarks das funções da simulação (Bird, Pipe e World), sem janela e sem OpenGL.
+// Uso: BenchmarkSimulacao [--filtro <texto>] [--repeticoes <n>] [--json <arquivo>]
+// Cada medição roda primeiro um aquecimento e depois várias repetições de um lote calibrado para durar
+// cerca de 10 ms; o relatório mostra a mediana, o mínimo e o desvio absoluto mediano em ns por operação,
+// e os ciclos do contador de tempo (TSC) por operação. O JSON tem uma medição por linha, sempre na mesma
+// ordem, para ser comparado com diff entre commits.
+#include <algorithm>  // sort.
+#include <chrono>  // steady_clock.
+#include <cstdint>  // int64_t, uint64_t.
+#include <cstdlib>  // atoi.
+#include <cstring>  // strcmp, strstr.
+#include <fstream>  // Saída em JSON.
+#include <functional>  // Corpo de cada medição.
+#include <iomanip>  // Formatação da tabela.
+#include <iostream>  // Tabela no console.
+#include <string>  // Nome da medição em lote.
+#include <vector>  // Lista de medições e amostras.
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>  // __rdtsc.
+#define BENCHMARK_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // __rdtsc.
+#define BENCHMARK_TSC
+#endif
+#include "batch_collision.h"  // collideBatch.
+#include "broadphase.h"  // BirdSweep.
+#include "game.h"  // Bird, Pipe, World.
+
+// Impede o compilador de descartar um resultado que não é usado.
+template <typename T>
+inline void keep(const T& value) {
+#ifdef _MSC_VER
+    static volatile T sink;
+    sink = value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint64_t readTsc() {
+#ifdef BENCHMARK_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Uma medição: run(ops) executa ops operações e retorna um valor derivado delas (para keep()).
+struct Benchmark {
+    const char* name;
+    std::function<uint64_t(int64_t)> run;
+};
+
+struct Result {
+    const char* name;
+    int64_t opsPerRepetition;
+    int repetitions;
+    double medianNs, minNs, madNs;  // Por operação.
+    double cyclesPerOp;  // Ciclos do TSC por operação (0 sem TSC).
+};
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+Result measure(const Benchmark& benchmark, int repetitions) {
+    const int64_t targetNs = 10000000;  // 10 ms por repetição.
+
+    // Calibra o lote dobrando o número de operações até passar de um décimo do alvo.
+    int64_t ops = 16;
+    for (;;) {
+        int64_t start = nowNs();
+        keep(benchmark.run(ops));
+        int64_t elapsed = nowNs() - start;
+        if (elapsed >= targetNs / 10 || ops >= (int64_t(1) << 40)) {
+            ops = elapsed > 0 ? ops * targetNs / elapsed : ops * 10;
+            ops = ops > 0 ? ops : 1;
+            break;
+        }
+        ops *= 2;
+    }
+
+    // Aquecimento: cerca de 100 ms, para estabilizar a frequência da CPU, os caches e o preditor de desvios.
+    for (int64_t start = nowNs(); nowNs() - start < 100000000;)
+        keep(benchmark.run(ops));
+
+    std::vector<double> perOp, cycles;
+    for (int i = 0; i < repetitions; ++i) {
+        uint64_t tscStart = readTsc();
+        int64_t start = nowNs();
+        keep(benchmark.run(ops));
+        int64_t elapsed = nowNs() - start;
+        uint64_t tscElapsed = readTsc() - tscStart;
+        perOp.push_back(static_cast<double>(elapsed) / ops);
+        cycles.push_back(static_cast<double>(tscElapsed) / ops);
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.opsPerRepetition = ops;
+    result.repetitions = repetitions;
+    result.medianNs = median(perOp);
+    result.minNs = *std::min_element(perOp.begin(), perOp.end());
+    std::vector<double> deviations;
+    for (double value : perOp)
+        deviations.push_back(value > result.medianNs ? value - result.medianNs : result.medianNs - value);
+    result.madNs = median(deviations);
+    result.cyclesPerOp = median(cycles);
+    return result;
+}
+
+// Pássaros espalhados pela altura da tela, para que os testes de colisão não sigam sempre o mesmo caminho.
+std::vector<Bird> scatteredBirds(int count, uint32_t seed) {
+    GameRng rng(seed);
+    std::vector<Bird> birds(count);
+    for (auto& bird : birds) {
+        bird.x = static_cast<float>(rng.next() % 200 + 350);
+        bird.y = static_cast<float>(rng.next() % 600);
+    }
+    return birds;
+}
+
+// Máscara de colisão circular (as ferramentas não têm o sprite embutido).
+CollisionMask circleMask() {
+    std::vector<unsigned char> circle(64 * 64 * 4, 0);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x)
+            circle[(y * 64 + x) * 4 + 3] = (x - 32) * (x - 32) + (y - 32) * (y - 32) < 28 * 28 ? 255 : 0;
+    }
+    return CollisionMask::fromRgba(circle.data(), 64, 64);
+}
+
+std::vector<Benchmark> benchmarks() {
+    std::vector<Benchmark> list;
+
+    list.push_back({ "Bird::update", [](int64_t ops) {
+        Bird bird;
+        for (int64_t i = 0; i < ops; ++i) {
+            if ((i & 1023) == 0)
+                bird.flap();  // Mantém o pássaro no ar, longe do caso do chão.
+            bird.update();
+        }
+        return static_cast<uint64_t>(bird.y);
+    } });
+
+    list.push_back({ "Bird::flap", [](int64_t ops) {
+        Bird bird;
+        float sum = 0.0f;
+        for (int64_t i = 0; i < ops; ++i) {
+            bird.flap();
+            keep(bird.velocity);
+            sum += bird.velocity;
+        }
+        return static_cast<uint64_t>(sum);
+    } });
+
+    list.push_back({ "Pipe::update", [](int64_t ops) {
+        Pipe pipe(400.0f, 300.0f);
+        GameRng rng(1);
+        for (int64_t i = 0; i < ops; ++i)
+            pipe.update(pipe_speed, rng);
+        return static_cast<uint64_t>(pipe.x) + rng.state;
+    } });
+
+    std::vector<Bird> birds = scatteredBirds(1024, 2);
+    list.push_back({ "Pipe::isColliding", [birds](int64_t ops) {
+        const Pipe pipe(450.0f, 250.0f);
+        uint64_t hits = 0;
+        for (int64_t i = 0; i < ops; ++i)
+            hits += pipe.isColliding(birds[i & 1023]) ? 1 : 0;
+        return hits;
+    } });
+
+    // Mesmo teste com uma máscara de colisão circular.
+    const CollisionMask mask = circleMask();
+    list.push_back({ "Pipe::isColliding (mascara)", [birds, mask](int64_t ops) {
+        const Pipe pipe(450.0f, 250.0f);
+        std::vector<Bird> masked(birds.size());
+        for (size_t i = 0; i < birds.size(); ++i) {
+            masked[i].x = birds[i].x;
+            masked[i].y = birds[i].y;
+            masked[i].mask = &mask;
+        }
+        uint64_t hits = 0;
+        for (int64_t i = 0; i < ops; ++i)
+            hits += pipe.isColliding(masked[i & 1023]) ? 1 : 0;
+        return hits;
+    } });
+
+    // Passo completo com uma batida de asas a cada 250 passos e reinício imediato ao perder, como em uma partida.
+    list.push_back({ "World::step", [](int64_t ops) {
+        World world(3);
+        for (int64_t i = 0; i < ops; ++i) {
+            if (i % 250 == 0)
+                world.apply(InputAction::Flap);
+            if (world.gameOver)
+                world.apply(InputAction::Reset);
+            world.step();
+        }
+        return world.hash();
+    } });
+
+    // O mesmo jogo em avanços de 50 passos (World::advance); uma operação é um passo simulado.
+    list.push_back({ "World::advance(50)", [](int64_t ops) {
+        World world(3);
+        for (int64_t i = 0; i < ops; i += 50) {
+            if (i % 250 == 0)
+                world.apply(InputAction::Flap);
+            if (world.gameOver)
+                world.apply(InputAction::Reset);
+            world.advance(50);
+        }
+        return world.hash();
+    } });
+
+    // População de 10 mil pássaros espalhados por uma fase de mil tubos (250 pixels entre eles). Uma operação
+    // é um quadro: os pássaros andam um pouco em x e todos são testados. Todos os pares contra a varredura e
+    // poda da BirdSweep, que dá o mesmo resultado (o TesteColisao confere).
+    std::vector<Pipe> level;
+    GameRng levelRng(5);
+    for (int i = 0; i < 1000; ++i)
+        level.push_back(Pipe(250.0f * i, static_cast<float>(levelRng.next() % 300 + 100)));
+    std::vector<Bird> population(10000);
+    for (auto& bird : population) {
+        bird.x = static_cast<float>(levelRng.next() % 250000);
+        bird.y = static_cast<float>(levelRng.next() % 600);
+    }
+    list.push_back({ "Colisao 10k x 1k (todos os pares)", [level, population](int64_t ops) mutable {
+        std::vector<unsigned char> dead(population.size());
+        uint64_t deaths = 0;
+        for (int64_t i = 0; i < ops; ++i) {
+            for (size_t b = 0; b < population.size(); ++b) {
+                population[b].x += (b + i) % 3 - 1.0f;
+                dead[b] = 0;
+                for (const auto& pipe : level) {
+                    if (pipe.isColliding(population[b])) {
+                        dead[b] = 1;
+                        break;
+                    }
+                }
+                deaths += dead[b];
+            }
+        }
+        return deaths;
+    } });
+    list.push_back({ "Colisao 10k x 1k (varredura)", [level, population](int64_t ops) mutable {
+        std::vector<unsigned char> dead(population.size());
+        int head = 0;
+        const PipeRing ring(level.data(), static_cast<int>(level.size()), head);
+        BirdSweep sweep;
+        uint64_t deaths = 0;
+        for (int64_t i = 0; i < ops; ++i) {
+            for (size_t b = 0; b < population.size(); ++b) {
+                population[b].x += (b + i) % 3 - 1.0f;
+                dead[b] = 0;
+            }
+            sweep.sort(population.data(), static_cast<int>(population.size()));
+            sweep.collide(population.data(), ring, dead.data());
+            for (unsigned char d : dead)
+                deaths += d;
+        }
+        return deaths;
+    } });
+
+    // Uma população de 4096 pássaros no mesmo x contra o tubo ativo; uma operação é um pássaro.
+    std::vector<float> heights;
+    for (const auto& bird : scatteredBirds(4096, 6))
+        heights.push_back(bird.y);
+    static const std::string simdName = std::string("Colisao em lote (") + batchCollisionIsa() + ")";
+    for (int simd = 0; simd <= 1; ++simd) {
+        list.push_back({ simd ? simdName.c_str() : "Colisao em lote (escalar)", [heights, simd](int64_t ops) {
+            const Pipe pipe(100.0f, 250.0f);
+            std::vector<uint64_t> dead(4096 / 64);
+            uint64_t deaths = 0;
+            for (int64_t i = 0; i < ops; i += 4096) {
+                std::fill(dead.begin(), dead.end(), 0);
+                collideBatch(heights.data(), 4096, 100.0f, pipe, dead.data(), nullptr, simd != 0);
+                keep(dead[0]);
+                deaths += dead[i / 4096 % 64];
+            }
+            return deaths;
+        } });
+    }
+
+    return list;
+}
+
+// Frequência do TSC em GHz, medida contra o steady_clock.
+double tscGhz() {
+#ifdef BENCHMARK_TSC
+    uint64_t tscStart = readTsc();
+    int64_t start = nowNs();
+    while (nowNs() - start < 50000000) {}
+    return static_cast<double>(readTsc() - tscStart) / (nowNs() - start);
+#else
+    return 0.0;
+#endif
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results, double ghz) {
+    out << "{\n  \"tsc_ghz\": " << std::fixed << std::setprecision(3) << ghz << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    { \"name\": \"" << r.name << "\", \"ns_per_op\": " << r.medianNs << ", \"ns_per_op_min\": " << r.minNs
+            << ", \"ns_per_op_mad\": " << r.madNs << ", \"cycles_per_op\": " << r.cyclesPerOp
+            << ", \"ops\": " << r.opsPerRepetition << ", \"repetitions\": " << r.repetitions << " }"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+    int repetitions = 15;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--filtro") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--repeticoes") == 0 && i + 1 < argc)
+            repetitions = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 1;
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else {
+            std::cerr << "Opção desconhecida: " << argv[i] << std::endl;
+            std::cerr << "Uso: " << argv[0] << " [--filtro <texto>] [--repeticoes <n>] [--json <arquivo>]" << std::endl;
+            return 1;
+        }
+    }
+    double ghz = tscGhz();
+    std::cout << std::left << std::setw(34) << "Medição" << std::right << std::setw(12) << "ns/op" << std::setw(12) << "mín"
+              << std::setw(12) << "desvio" << std::setw(12) << "ciclos/op" << std::endl;
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : benchmarks()) {
+        if (filter && !strstr(benchmark.name, filter))
+            continue;
+        Result r = measure(benchmark, repetitions);
+        results.push_back(r);
+        std::cout << std::left << std::setw(34) << r.name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << r.medianNs << std::setw(12) << r.minNs << std::setw(12) << r.madNs
+                  << std::setprecision(2) << std::setw(12) << r.cyclesPerOp << std::endl;
+    }
+
+    if (jsonPath) {
+        std::ofstream out(jsonPath);
+        writeJson(out, results, ghz);
+        if (!out) {
+            std::cerr << "Falha ao gravar " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
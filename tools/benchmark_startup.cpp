@@ -0,0 +1,268 @@
+// Benchmark da inicialização: executa o jogo várias vezes com --tempo-inicializacao e
+// --sair-no-primeiro-quadro e mostra a mediana, o mínimo e o máximo de cada etapa, além do tempo do
+// lançamento do processo até o primeiro quadro completo (que inclui o carregamento do executável e das
+// bibliotecas, antes de main()).
+// Uso: BenchmarkInicializacao <executável do jogo> [--execucoes <n>] [--frio] [--limite <s>] [-- <opções do jogo>]
+// Partida quente: a primeira execução é descartada e as demais encontram os arquivos no cache do sistema.
+// Partida fria (--frio, apenas no Linux e como root): o cache de páginas é esvaziado antes de cada execução,
+// como depois de reiniciar o quiosque.
+// Uma execução que não termina em --limite segundos (30 por padrão) é encerrada e conta como falha.
+#include <algorithm>  // sort.
+#include <chrono>  // steady_clock.
+#include <cstdio>  // sscanf.
+#include <cstdlib>  // atoi.
+#include <cstring>  // strcmp, strncmp.
+#include <iomanip>  // Formatação da tabela.
+#include <iostream>  // Tabela no console.
+#include <string>  // Linha de comando e nomes das etapas.
+#include <utility>  // pair.
+#include <vector>  // Amostras por etapa.
+#ifdef _WIN32
+#include <windows.h>  // CreateProcess, pipes anônimos, TerminateProcess.
+#else
+#include <fcntl.h>  // open.
+#include <poll.h>  // Espera pela saída do jogo com tempo limite.
+#include <signal.h>  // kill.
+#include <sys/wait.h>  // waitpid.
+#include <unistd.h>  // sync, write, close, fork, exec.
+#endif
+
+// Esvazia o cache de páginas do Linux. Retorna false se não for possível (outro sistema ou sem permissão).
+bool dropPageCache() {
+#ifdef __linux__
+    sync();
+    int fd = open("/proc/sys/vm/drop_caches", O_WRONLY);
+    if (fd < 0)
+        return false;
+    bool ok = write(fd, "3", 1) == 1;
+    close(fd);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+// Amostras de uma etapa, na ordem em que as etapas aparecem no relatório do jogo.
+typedef std::vector<std::pair<std::string, std::vector<double>>> PhaseSamples;
+
+void addSample(PhaseSamples& phases, const std::string& name, double ms) {
+    for (auto& phase : phases) {
+        if (phase.first == name) {
+            phase.second.push_back(ms);
+            return;
+        }
+    }
+    phases.push_back({ name, { ms } });
+}
+
+// Processo do jogo com a saída padrão redirecionada para um pipe, lida linha a linha com tempo limite.
+class GameProcess {
+public:
+    bool start(const std::string& command) {
+#ifdef _WIN32
+        SECURITY_ATTRIBUTES attributes = { sizeof(attributes), nullptr, TRUE };
+        HANDLE write;
+        if (!CreatePipe(&output, &write, &attributes, 0))
+            return false;
+        SetHandleInformation(output, HANDLE_FLAG_INHERIT, 0);
+        STARTUPINFOA startup = {};
+        startup.cb = sizeof(startup);
+        startup.dwFlags = STARTF_USESTDHANDLES;
+        startup.hStdOutput = write;
+        startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+        std::string commandLine = command;
+        bool started = CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startup, &process) != 0;
+        CloseHandle(write);
+        return started;
+#else
+        int fds[2];
+        if (pipe(fds) != 0)
+            return false;
+        pid = fork();
+        if (pid == 0) {
+            dup2(fds[1], STDOUT_FILENO);
+            close(fds[0]);
+            close(fds[1]);
+            execl("/bin/sh", "sh", "-c", ("exec " + command).c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        close(fds[1]);
+        output = fds[0];
+        return pid > 0;
+#endif
+    }
+
+    // Lê a próxima linha (sem o \n). Retorna false no fim da saída ou quando deadline passa.
+    bool readLine(std::string& line, std::chrono::steady_clock::time_point deadline) {
+        line.clear();
+        while (true) {
+            size_t end = buffer.find('\n');
+            if (end != std::string::npos) {
+                line = buffer.substr(0, end);
+                buffer.erase(0, end + 1);
+                return true;
+            }
+            char chunk[512];
+            long count = readChunk(chunk, sizeof(chunk), deadline);
+            if (count <= 0)
+                return false;
+            buffer.append(chunk, static_cast<size_t>(count));
+        }
+    }
+
+    // Espera o fim do processo; se ele ainda estiver rodando (tempo esgotado), encerra-o antes.
+    // Retorna o código de saída, ou -1 se foi encerrado.
+    int finish(bool kill) {
+#ifdef _WIN32
+        if (kill)
+            TerminateProcess(process.hProcess, 1);
+        WaitForSingleObject(process.hProcess, INFINITE);
+        DWORD status = 1;
+        GetExitCodeProcess(process.hProcess, &status);
+        CloseHandle(process.hProcess);
+        CloseHandle(process.hThread);
+        CloseHandle(output);
+        return kill ? -1 : static_cast<int>(status);
+#else
+        if (kill)
+            ::kill(pid, SIGKILL);
+        int status = 0;
+        waitpid(pid, &status, 0);
+        close(output);
+        return kill || !WIFEXITED(status) ? -1 : WEXITSTATUS(status);
+#endif
+    }
+
+private:
+    // Lê o que houver na saída, esperando até deadline. Retorna 0 no fim da saída e -1 no tempo esgotado.
+    long readChunk(char* chunk, size_t size, std::chrono::steady_clock::time_point deadline) {
+        while (true) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0)
+                return -1;
+#ifdef _WIN32
+            DWORD available = 0;
+            if (!PeekNamedPipe(output, nullptr, 0, nullptr, &available, nullptr))
+                return 0;  // O processo fechou a saída.
+            if (available == 0) {
+                Sleep(10);
+                continue;
+            }
+            DWORD count = 0;
+            if (!ReadFile(output, chunk, static_cast<DWORD>(size), &count, nullptr))
+                return 0;
+            return static_cast<long>(count);
+#else
+            pollfd fd = { output, POLLIN, 0 };
+            if (poll(&fd, 1, static_cast<int>(remaining.count())) <= 0)
+                continue;
+            ssize_t count = read(output, chunk, size);
+            return count < 0 ? 0 : static_cast<long>(count);
+#endif
+        }
+    }
+
+#ifdef _WIN32
+    HANDLE output = nullptr;
+    PROCESS_INFORMATION process = {};
+#else
+    int output = -1;
+    pid_t pid = -1;
+#endif
+    std::string buffer;
+};
+
+// Executa o jogo uma vez. Retorna false se ele não chegou ao primeiro quadro completo, terminou com erro
+// ou passou de timeoutSeconds.
+bool runOnce(const std::string& command, PhaseSamples& phases, int timeoutSeconds) {
+    auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::seconds(timeoutSeconds);
+    GameProcess game;
+    if (!game.start(command))
+        return false;
+
+    PhaseSamples run;
+    bool firstFrame = false;
+    std::string line;
+    while (game.readLine(line, deadline)) {
+        char name[64];
+        double phaseMs, totalMs;
+        if (strncmp(line.c_str(), "  ", 2) == 0 && sscanf(line.c_str(), "%63s %lf %lf", name, &phaseMs, &totalMs) == 3) {
+            addSample(run, name, phaseMs);
+        }
+        else if (strncmp(line.c_str(), "Primeiro quadro completo em ", 28) == 0) {
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            addSample(run, "processo_ate_quadro", elapsed.count());
+            firstFrame = true;
+        }
+    }
+    const bool timedOut = std::chrono::steady_clock::now() >= deadline;
+    int status = game.finish(timedOut);
+    if (timedOut)
+        std::cerr << "Execução encerrada depois de " << timeoutSeconds << " s sem terminar." << std::endl;
+    if (!firstFrame || status != 0)
+        return false;
+    for (const auto& phase : run)
+        addSample(phases, phase.first, phase.second[0]);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " <executável do jogo> [--execucoes <n>] [--frio] [--limite <s>] [-- <opções do jogo>]" << std::endl;
+        return 1;
+    }
+    std::string command = std::string("\"") + argv[1] + "\" --tempo-inicializacao --sair-no-primeiro-quadro";
+    int runs = 10;
+    bool cold = false;
+    int timeoutSeconds = 30;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--execucoes") == 0 && i + 1 < argc)
+            runs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--frio") == 0)
+            cold = true;
+        else if (strcmp(argv[i], "--limite") == 0 && i + 1 < argc)
+            timeoutSeconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--") == 0) {
+            for (++i; i < argc; ++i)
+                command += std::string(" \"") + argv[i] + "\"";
+        }
+        else {
+            std::cerr << "Opção desconhecida: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (cold && !dropPageCache()) {
+        std::cerr << "Não foi possível esvaziar o cache de páginas (--frio requer Linux e root)." << std::endl;
+        return 1;
+    }
+
+    PhaseSamples phases;
+    if (!cold) {
+        PhaseSamples discarded;
+        runOnce(command, discarded, timeoutSeconds);  // Aquecimento: traz o executável e as bibliotecas para o cache.
+    }
+    int failures = 0;
+    for (int i = 0; i < runs; ++i) {
+        if (cold)
+            dropPageCache();
+        if (!runOnce(command, phases, timeoutSeconds))
+            ++failures;
+    }
+
+    std::cout << "Partida " << (cold ? "fria" : "quente") << ", " << runs - failures << " execuções" << std::endl;
+    std::cout << std::left << std::setw(28) << "Etapa (ms)" << std::right << std::setw(10) << "mediana" << std::setw(10)
+              << "mín" << std::setw(10) << "máx" << std::endl;
+    for (auto& phase : phases) {
+        std::vector<double>& samples = phase.second;
+        std::sort(samples.begin(), samples.end());
+        size_t n = samples.size();
+        double median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+        std::cout << std::left << std::setw(28) << phase.first << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << median << std::setw(10) << samples.front() << std::setw(10) << samples.back() << std::endl;
+    }
+    if (failures > 0)
+        std::cerr << failures << " execuções não chegaram ao primeiro quadro (ou passaram do limite)." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+// Ferramenta offline que converte imagens (.png, .jpg, etc.) para .dds com blocos BC1/BC3 e mipmaps.
+// Uso: CompressorTexturas <entrada> <saida.dds> [--bc1 | --bc3] [--hq]
+// Sem --bc1/--bc3 o formato é escolhido automaticamente: BC3 se a imagem tiver transparência, BC1 caso contrário.
+#include <iostream>  // Mensagens de uso e erro.
+#include <cstring>  // strcmp, memcpy.
+#include <vector>  // Buffers dos níveis de mipmap.
+#define STB_IMAGE_IMPLEMENTATION  // Define a implementação de stb_image.
+#include "stb_image.h"  // Biblioteca para carregar imagens.
+#define STB_DXT_IMPLEMENTATION  // Define a implementação de stb_dxt.
+#include "stb_dxt.h"  // Compressor de blocos DXT1/DXT5.
+#include "dds.h"  // Estruturas e gravação do formato .dds.
+
+// Reduz uma imagem RGBA8 pela metade fazendo a média de cada bloco 2x2 (filtro de caixa).
+std::vector<unsigned char> downsample(const std::vector<unsigned char>& src, int width, int height, int& outWidth, int& outHeight) {
+    outWidth = width > 1 ? width / 2 : 1;
+    outHeight = height > 1 ? height / 2 : 1;
+    std::vector<unsigned char> dst(static_cast<size_t>(outWidth) * outHeight * 4);
+
+    for (int y = 0; y < outHeight; ++y) {
+        for (int x = 0; x < outWidth; ++x) {
+            int x0 = x * 2, y0 = y * 2;
+            int x1 = x0 + 1 < width ? x0 + 1 : x0;
+            int y1 = y0 + 1 < height ? y0 + 1 : y0;
+            for (int c = 0; c < 4; ++c) {
+                int sum = src[(static_cast<size_t>(y0) * width + x0) * 4 + c] + src[(static_cast<size_t>(y0) * width + x1) * 4 + c] +
+                          src[(static_cast<size_t>(y1) * width + x0) * 4 + c] + src[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+                dst[(static_cast<size_t>(y) * outWidth + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+// Comprime um nível RGBA8 em blocos 4x4. Os blocos da borda repetem o último pixel válido.
+DdsLevel compressLevel(const std::vector<unsigned char>& rgba, int width, int height, bool hasAlpha, int mode) {
+    DdsLevel level;
+    level.width = width;
+    level.height = height;
+    level.blocks.resize(ddsLevelSize(width, height, hasAlpha));
+
+    const int blockSize = ddsBlockSize(hasAlpha);
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    unsigned char block[16 * 4];
+
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            for (int py = 0; py < 4; ++py) {
+                int y = by * 4 + py < height ? by * 4 + py : height - 1;
+                for (int px = 0; px < 4; ++px) {
+                    int x = bx * 4 + px < width ? bx * 4 + px : width - 1;
+                    memcpy(block + (py * 4 + px) * 4, &rgba[(static_cast<size_t>(y) * width + x) * 4], 4);
+                }
+            }
+            unsigned char* dest = level.blocks.data() + (static_cast<size_t>(by) * blocksX + bx) * blockSize;
+            stb_compress_dxt_block(dest, block, hasAlpha ? 1 : 0, mode);
+        }
+    }
+    return level;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <entrada> <saida.dds> [--bc1 | --bc3] [--hq]" << std::endl;
+        return 1;
+    }
+
+    int forced = -1;  // -1 = automático, 0 = BC1, 1 = BC3.
+    int mode = STB_DXT_NORMAL;
+    for (int i = 3; i < argc; ++i) {
+        if (strcmp(argv[i], "--bc1") == 0)
+            forced = 0;
+        else if (strcmp(argv[i], "--bc3") == 0)
+            forced = 1;
+        else if (strcmp(argv[i], "--hq") == 0)
+            mode = STB_DXT_HIGHQUAL;
+        else {
+            std::cerr << "Opção desconhecida: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    int width, height, nrChannels;
+    unsigned char* data = stbi_load(argv[1], &width, &height, &nrChannels, 4);  // Sempre converte para RGBA.
+    if (!data) {
+        std::cerr << "Falha ao carregar a imagem: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<unsigned char> rgba(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+
+    // Detecta se algum pixel é transparente para decidir entre BC1 e BC3.
+    bool hasAlpha = false;
+    for (size_t i = 3; i < rgba.size() && !hasAlpha; i += 4)
+        hasAlpha = rgba[i] != 255;
+    if (forced != -1)
+        hasAlpha = forced == 1;
+
+    // Gera a cadeia completa de mipmaps até 1x1, comprimindo cada nível.
+    DdsImage image;
+    image.hasAlpha = hasAlpha;
+    int levelWidth = width, levelHeight = height;
+    while (true) {
+        image.levels.push_back(compressLevel(rgba, levelWidth, levelHeight, hasAlpha, mode));
+        if (levelWidth == 1 && levelHeight == 1)
+            break;
+        rgba = downsample(rgba, levelWidth, levelHeight, levelWidth, levelHeight);
+    }
+
+    if (!writeDds(argv[2], image)) {
+        std::cerr << "Falha ao gravar: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    size_t compressed = 0;
+    for (const auto& level : image.levels)
+        compressed += level.blocks.size();
+    std::cout << argv[2] << ": " << width << "x" << height << " " << (hasAlpha ? "BC3" : "BC1") << ", "
+              << image.levels.size() << " níveis, " << compressed << " bytes (RGBA8 sem mipmaps: "
+              << static_cast<size_t>(width) * height * 4 << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Ferramenta de build que decodifica imagens e gera um cabeçalho C++ com os pixels já prontos para o OpenGL,
+// para que o jogo não precise ler nem decodificar arquivos na inicialização.
+// Uso: EmbutirAssets <saida.h> <imagem1> [imagem2 ...]
+// Cada imagem vira um EmbeddedImage (texture.h) chamado embedded::<nome do arquivo sem extensão>.
+#include <iostream>  // Mensagens de erro.
+#include <fstream>  // Gravação do cabeçalho gerado.
+#include <string>  // Nomes dos identificadores gerados.
+#define STB_IMAGE_IMPLEMENTATION  // Define a implementação de stb_image.
+#include "stb_image.h"  // Biblioteca para carregar imagens.
+
+// Converte o nome do arquivo (sem diretório e extensão) em um identificador C++ válido.
+std::string identifierFor(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos)
+        name = name.substr(0, dot);
+
+    for (auto& c : name) {
+        bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        if (!valid)
+            c = '_';
+    }
+    if (name.empty() || (name[0] >= '0' && name[0] <= '9'))
+        name = "_" + name;
+    return name;
+}
+
+// Escapa barras invertidas e aspas para usar o caminho dentro de uma string C++.
+std::string escaped(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '\\' || c == '"')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <saida.h> <imagem1> [imagem2 ...]" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(argv[1]);
+    if (!out) {
+        std::cerr << "Falha ao gravar: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    out << "// Gerado pelo EmbutirAssets (tools/embed_assets.cpp) durante o build. Não edite.\n";
+    out << "#pragma once\n\n";
+    out << "#include \"texture.h\"  // EmbeddedImage.\n\n";
+    out << "namespace embedded {\n";
+
+    for (int i = 2; i < argc; ++i) {
+        int width, height, nrChannels;
+        unsigned char* data = stbi_load(argv[i], &width, &height, &nrChannels, 4);  // Sempre RGBA, pronto para glTexImage2D.
+        if (!data) {
+            std::cerr << "Falha ao carregar a imagem: " << argv[i] << std::endl;
+            return 1;
+        }
+
+        std::string name = identifierFor(argv[i]);
+        size_t size = static_cast<size_t>(width) * height * 4;
+        out << "\n// " << argv[i] << ": " << width << "x" << height << " RGBA8, " << size << " bytes.\n";
+        out << "constexpr int " << name << "_width = " << width << ";\n";
+        out << "constexpr int " << name << "_height = " << height << ";\n";
+        out << "constexpr unsigned char " << name << "_pixels[" << size << "] = {";
+        for (size_t j = 0; j < size; ++j) {
+            if (j % 32 == 0)
+                out << "\n    ";
+            out << static_cast<int>(data[j]) << ",";
+        }
+        out << "\n};\n";
+        out << "constexpr EmbeddedImage " << name << " = { \"" << name << "\", \"" << escaped(argv[i]) << "\", "
+            << name << "_width, " << name << "_height, " << name << "_pixels };\n";
+        stbi_image_free(data);
+    }
+
+    out << "\n}  // namespace embedded\n";
+    return out ? 0 : 1;
+}